@@ -0,0 +1,791 @@
+// Load generator: drives thousands of simulated players through
+// register -> login -> lobby -> invite -> match -> history flows and reports
+// throughput and latency percentiles per request type.
+//
+// Players are grouped in pairs (host + guest). Each worker thread owns a set
+// of pairs and multiplexes their sockets with its own epoll instance.
+//
+// Usage: load_generator [--host H] [--port P] [--pairs N] [--threads T]
+//                       [--rounds R] [--rate ROUNDS_PER_SEC] [--duration SEC]
+//                       [--prefix NAME]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "protocol/packets.h"
+#include "protocol/packet_types.h"
+#include "protocol/bytebuffer.h"
+
+using namespace hangman;
+
+namespace {
+
+struct Options {
+    std::string host = "127.0.0.1";
+    int port = 5000;
+    int pairs = 500;
+    int threads = 4;
+    int rounds = 3;
+    double rate = 0;       // Rounds started per second across all pairs, 0 = unthrottled
+    int duration = 60;     // Hard stop (seconds)
+    std::string prefix;    // Username prefix, defaults to "bench<pid>"
+};
+
+uint64_t nowNs() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Guess order: finishes the server's current word in five guesses, then falls
+// back to English letter frequency for any other word
+const char GUESS_ORDER[] = "HANGMEIORSTLUCDPBFKVWYXJQZ";
+
+enum class Step {
+    REGISTER,
+    LOGIN,
+    IDLE,            // Host: waiting to start a round / Guest: waiting for an invite
+    ONLINE_LIST,
+    CREATE_ROOM,
+    SEND_INVITE,
+    WAIT_JOIN,       // Host: waiting for InviteResponse + PlayerReadyUpdate
+    RESPOND_INVITE,
+    SET_READY,
+    START_GAME,
+    WAIT_GAME_START,
+    GUESS,
+    END_GAME,
+    WAIT_GAME_END,   // Guest: waiting for the host's EndGame
+    LEAVE_ROOM,
+    HISTORY,
+    LOGOUT,
+    DONE,
+    FAILED
+};
+
+struct Pair;
+
+struct Player {
+    int fd = -1;
+    bool host = false;
+    Pair* pair = nullptr;
+    std::string username;
+    std::string token;
+
+    std::vector<uint8_t> in;   // Unparsed received bytes
+    std::vector<uint8_t> out;  // Bytes the socket did not accept yet
+    bool wantWrite = false;
+
+    Step step = Step::REGISTER;
+    uint16_t requestType = 0;  // Outstanding request (0 = none)
+    uint16_t expectType = 0;   // Response type that completes it
+    uint64_t sentAt = 0;
+
+    uint32_t roomId = 0;
+    size_t guessIndex = 0;
+    int roundsDone = 0;
+
+    // Pushes that may arrive before the player is ready for them
+    bool gotInvite = false;
+    std::string inviteFrom;
+    bool gotInviteAccepted = false;
+    bool gotReadyUpdate = false;
+    bool gotGameStart = false;
+    bool gotGameEnd = false;
+};
+
+struct Pair {
+    Player host;
+    Player guest;
+};
+
+struct TypeStats {
+    std::vector<uint64_t> latencies;  // ns
+    uint64_t errors = 0;
+};
+
+class Worker {
+public:
+    Worker(const Options& options, int index, double roundsPerSec)
+        : options(options), index(index), roundsPerSec(roundsPerSec) {}
+
+    void addPair(int id) {
+        auto pair = std::make_unique<Pair>();
+        pair->host.host = true;
+        pair->host.pair = pair.get();
+        pair->host.username = options.prefix + "_" + std::to_string(id) + "h";
+        pair->guest.pair = pair.get();
+        pair->guest.username = options.prefix + "_" + std::to_string(id) + "g";
+        pairs.push_back(std::move(pair));
+    }
+
+    bool connectAll(const sockaddr_in& addr);
+    void run(uint64_t deadline);
+
+    std::map<uint16_t, TypeStats> stats;
+    uint64_t roundsCompleted = 0;
+    uint64_t failedPlayers = 0;
+    uint64_t unfinishedPlayers = 0;
+    uint64_t protocolErrors = 0;
+
+private:
+    void send(Player& p, const std::vector<uint8_t>& packet, uint16_t requestType, uint16_t expectType);
+    void flushOut(Player& p);
+    void onReadable(Player& p);
+    void onPacket(Player& p, uint16_t type, ByteBuffer& payload);
+    void advance(Player& p);
+    void fail(Player& p, const char* why);
+    bool takeRoundToken();
+    void startRound(Player& host);
+    void sendGuess(Player& p);
+    void updateInterest(Player& p);
+
+    const Options& options;
+    int index;
+    double roundsPerSec;
+    double tokens = 1;
+    uint64_t lastRefill = 0;
+    int epollFd = -1;
+    std::vector<std::unique_ptr<Pair>> pairs;
+    std::vector<Player*> waitingHosts;  // Hosts ready for a round, throttled by --rate
+    size_t active = 0;                  // Players not yet DONE/FAILED
+};
+
+bool Worker::connectAll(const sockaddr_in& addr) {
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        return false;
+    }
+
+    for (auto& pair : pairs) {
+        for (Player* p : {&pair->host, &pair->guest}) {
+            p->fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            if (p->fd < 0 || connect(p->fd, (const sockaddr*)&addr, sizeof(addr)) < 0) {
+                std::cerr << "worker " << index << ": connect failed: " << strerror(errno) << std::endl;
+                return false;
+            }
+            int one = 1;
+            setsockopt(p->fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            fcntl(p->fd, F_SETFL, fcntl(p->fd, F_GETFL, 0) | O_NONBLOCK);
+
+            epoll_event ev{};
+            ev.events = EPOLLIN;
+            ev.data.ptr = p;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, p->fd, &ev);
+            ++active;
+        }
+    }
+    return true;
+}
+
+void Worker::updateInterest(Player& p) {
+    bool want = !p.out.empty();
+    if (want == p.wantWrite) {
+        return;
+    }
+    p.wantWrite = want;
+    epoll_event ev{};
+    ev.events = want ? (EPOLLIN | EPOLLOUT) : EPOLLIN;
+    ev.data.ptr = &p;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, p.fd, &ev);
+}
+
+void Worker::flushOut(Player& p) {
+    while (!p.out.empty()) {
+        ssize_t n = ::send(p.fd, p.out.data(), p.out.size(), MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            fail(p, "send failed");
+            return;
+        }
+        p.out.erase(p.out.begin(), p.out.begin() + n);
+    }
+    updateInterest(p);
+}
+
+void Worker::send(Player& p, const std::vector<uint8_t>& packet, uint16_t requestType, uint16_t expectType) {
+    p.requestType = requestType;
+    p.expectType = expectType;
+    p.sentAt = nowNs();
+    p.out.insert(p.out.end(), packet.begin(), packet.end());
+    flushOut(p);
+}
+
+void Worker::fail(Player& p, const char* why) {
+    if (p.step == Step::FAILED || p.step == Step::DONE) {
+        return;
+    }
+    if (failedPlayers < 5) {
+        std::cerr << "player " << p.username << " failed: " << why << std::endl;
+    }
+    p.step = Step::FAILED;
+    ++failedPlayers;
+    --active;
+    if (p.fd >= 0) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, p.fd, nullptr);
+    }
+}
+
+bool Worker::takeRoundToken() {
+    if (roundsPerSec <= 0) {
+        return true;
+    }
+    uint64_t now = nowNs();
+    if (lastRefill == 0) {
+        lastRefill = now;
+    }
+    tokens = std::min(tokens + (now - lastRefill) * roundsPerSec / 1e9, std::max(1.0, roundsPerSec));
+    lastRefill = now;
+    if (tokens < 1) {
+        return false;
+    }
+    tokens -= 1;
+    return true;
+}
+
+void Worker::startRound(Player& host) {
+    host.gotInviteAccepted = false;
+    host.gotReadyUpdate = false;
+    host.gotGameStart = false;
+    host.gotGameEnd = false;
+    host.guessIndex = 0;
+    host.step = Step::ONLINE_LIST;
+
+    C2S_RequestOnlineList req;
+    req.session_token = host.token;
+    send(host, req.to_bytes(), (uint16_t)PacketType::C2S_RequestOnlineList, (uint16_t)PacketType::S2C_OnlineList);
+}
+
+void Worker::sendGuess(Player& p) {
+    if (p.guessIndex >= sizeof(GUESS_ORDER) - 1) {
+        fail(p, "ran out of letters");
+        return;
+    }
+    C2S_GuessChar req;
+    req.session_token = p.token;
+    req.room_id = p.roomId;
+    req.match_id = p.roomId;
+    req.ch = GUESS_ORDER[p.guessIndex++];
+    send(p, req.to_bytes(), (uint16_t)PacketType::C2S_GuessChar, (uint16_t)PacketType::S2C_GuessCharResult);
+}
+
+// Move a player forward once nothing is outstanding
+void Worker::advance(Player& p) {
+    if (p.requestType != 0 || p.step == Step::FAILED || p.step == Step::DONE) {
+        return;
+    }
+    Player& partner = p.host ? p.pair->guest : p.pair->host;
+
+    switch (p.step) {
+        case Step::REGISTER: {
+            C2S_Register req;
+            req.username = p.username;
+            req.password = "benchpass";
+            send(p, req.to_bytes(), (uint16_t)PacketType::C2S_Register, (uint16_t)PacketType::S2C_RegisterResult);
+            break;
+        }
+        case Step::LOGIN: {
+            C2S_Login req;
+            req.username = p.username;
+            req.password = "benchpass";
+            send(p, req.to_bytes(), (uint16_t)PacketType::C2S_Login, (uint16_t)PacketType::S2C_LoginResult);
+            break;
+        }
+        case Step::IDLE:
+            if (p.host) {
+                // Start only when the guest is logged in and idle (otherwise the invite bounces)
+                if (partner.step == Step::IDLE && partner.requestType == 0) {
+                    if (takeRoundToken()) {
+                        startRound(p);
+                    } else if (std::find(waitingHosts.begin(), waitingHosts.end(), &p) == waitingHosts.end()) {
+                        waitingHosts.push_back(&p);
+                    }
+                }
+            } else if (p.gotInvite) {
+                p.gotInvite = false;
+                p.gotGameStart = false;
+                p.gotGameEnd = false;
+                p.guessIndex = 0;
+                p.step = Step::RESPOND_INVITE;
+                C2S_RespondInvite req;
+                req.session_token = p.token;
+                req.from_username = p.inviteFrom;
+                req.accept = true;
+                send(p, req.to_bytes(), (uint16_t)PacketType::C2S_RespondInvite, (uint16_t)PacketType::S2C_CreateRoomResult);
+            }
+            break;
+        case Step::CREATE_ROOM: {
+            C2S_CreateRoom req;
+            req.session_token = p.token;
+            req.room_name = p.username + "_room";
+            send(p, req.to_bytes(), (uint16_t)PacketType::C2S_CreateRoom, (uint16_t)PacketType::S2C_CreateRoomResult);
+            break;
+        }
+        case Step::SEND_INVITE: {
+            C2S_SendInvite req;
+            req.session_token = p.token;
+            req.target_username = partner.username;
+            req.room_id = p.roomId;
+            send(p, req.to_bytes(), (uint16_t)PacketType::C2S_SendInvite, (uint16_t)PacketType::S2C_Ack);
+            break;
+        }
+        case Step::WAIT_JOIN:
+            if (p.gotInviteAccepted && p.gotReadyUpdate) {
+                p.step = Step::START_GAME;
+                C2S_StartGame req;
+                req.session_token = p.token;
+                req.room_id = p.roomId;
+                send(p, req.to_bytes(), (uint16_t)PacketType::C2S_StartGame, (uint16_t)PacketType::S2C_Ack);
+            }
+            break;
+        case Step::SET_READY: {
+            C2S_SetReady req;
+            req.session_token = p.token;
+            req.room_id = p.roomId;
+            req.ready = true;
+            send(p, req.to_bytes(), (uint16_t)PacketType::C2S_SetReady, (uint16_t)PacketType::S2C_Ack);
+            break;
+        }
+        case Step::WAIT_GAME_START:
+            if (p.gotGameStart) {
+                p.step = Step::GUESS;
+                sendGuess(p);
+            }
+            break;
+        case Step::GUESS:
+            sendGuess(p);
+            break;
+        case Step::END_GAME: {
+            C2S_EndGame req;
+            req.session_token = p.token;
+            req.room_id = p.roomId;
+            req.match_id = p.roomId;
+            req.result_code = 1;
+            req.message = "bench";
+            send(p, req.to_bytes(), (uint16_t)PacketType::C2S_EndGame, (uint16_t)PacketType::S2C_GameEnd);
+            break;
+        }
+        case Step::WAIT_GAME_END:
+            if (p.gotGameEnd) {
+                p.step = Step::LEAVE_ROOM;
+                advance(p);
+            }
+            break;
+        case Step::LEAVE_ROOM: {
+            C2S_LeaveRoom req;
+            req.session_token = p.token;
+            req.room_id = p.roomId;
+            send(p, req.to_bytes(), (uint16_t)PacketType::C2S_LeaveRoom, (uint16_t)PacketType::S2C_LeaveRoomAck);
+            break;
+        }
+        case Step::HISTORY: {
+            C2S_RequestHistory req;
+            req.session_token = p.token;
+            send(p, req.to_bytes(), (uint16_t)PacketType::C2S_RequestHistory, (uint16_t)PacketType::S2C_HistoryList);
+            break;
+        }
+        case Step::LOGOUT: {
+            C2S_Logout req;
+            req.session_token = p.token;
+            send(p, req.to_bytes(), (uint16_t)PacketType::C2S_Logout, (uint16_t)PacketType::S2C_LogoutAck);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void Worker::onReadable(Player& p) {
+    uint8_t chunk[16384];
+    while (true) {
+        ssize_t n = ::recv(p.fd, chunk, sizeof(chunk), 0);
+        if (n > 0) {
+            p.in.insert(p.in.end(), chunk, chunk + n);
+            continue;
+        }
+        if (n == 0) {
+            fail(p, "server closed connection");
+            return;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        fail(p, "recv failed");
+        return;
+    }
+
+    size_t pos = 0;
+    ByteBuffer payload;
+    while (p.in.size() - pos >= PacketHeader::HEADER_SIZE) {
+        const uint8_t* h = p.in.data() + pos;
+        uint16_t type = (uint16_t)((h[1] << 8) | h[2]);
+        uint32_t len = ((uint32_t)h[3] << 24) | ((uint32_t)h[4] << 16) | ((uint32_t)h[5] << 8) | h[6];
+        if (p.in.size() - pos < PacketHeader::HEADER_SIZE + len) {
+            break;
+        }
+        payload.buf.assign(h + PacketHeader::HEADER_SIZE, h + PacketHeader::HEADER_SIZE + len);
+        payload.rpos = 0;
+        pos += PacketHeader::HEADER_SIZE + len;
+
+        try {
+            onPacket(p, type, payload);
+        } catch (const std::exception& e) {
+            ++protocolErrors;
+            fail(p, e.what());
+        }
+        if (p.step == Step::FAILED) {
+            return;
+        }
+    }
+    p.in.erase(p.in.begin(), p.in.begin() + pos);
+}
+
+void Worker::onPacket(Player& p, uint16_t type, ByteBuffer& payload) {
+    // Server pushes (may interleave with responses)
+    switch ((PacketType)type) {
+        case PacketType::S2C_InviteReceived: {
+            S2C_InviteReceived push = S2C_InviteReceived::from_payload(payload);
+            p.gotInvite = true;
+            p.inviteFrom = push.from_username;
+            advance(p);
+            return;
+        }
+        case PacketType::S2C_InviteResponse: {
+            S2C_InviteResponse push = S2C_InviteResponse::from_payload(payload);
+            if (!push.accepted) {
+                fail(p, "invite declined");
+                return;
+            }
+            p.gotInviteAccepted = true;
+            advance(p);
+            return;
+        }
+        case PacketType::S2C_PlayerReadyUpdate:
+            p.gotReadyUpdate = true;
+            advance(p);
+            return;
+        case PacketType::S2C_GameStart:
+            p.gotGameStart = true;
+            advance(p);
+            return;
+        case PacketType::S2C_PlayerLeftNotification:
+            return;
+        case PacketType::S2C_GameEnd:
+            if (!p.host) {
+                p.gotGameEnd = true;
+                advance(p);
+                return;
+            }
+            break;  // Host: response to its own EndGame
+        default:
+            break;
+    }
+
+    if (p.requestType == 0 || (type != p.expectType && type != (uint16_t)PacketType::S2C_Error)) {
+        ++protocolErrors;
+        return;  // Unsolicited packet we do not care about
+    }
+
+    TypeStats& st = stats[p.requestType];
+    st.latencies.push_back(nowNs() - p.sentAt);
+    uint16_t request = p.requestType;
+    p.requestType = 0;
+    p.expectType = 0;
+
+    if (type == (uint16_t)PacketType::S2C_Error) {
+        S2C_Error err = S2C_Error::from_payload(payload);
+        ++st.errors;
+        fail(p, err.message.c_str());
+        return;
+    }
+
+    switch ((PacketType)request) {
+        case PacketType::C2S_Register:
+            p.step = Step::LOGIN;  // Already registered (reused prefix) is fine
+            break;
+        case PacketType::C2S_Login: {
+            S2C_LoginResult res = S2C_LoginResult::from_payload(payload);
+            if (res.code != ResultCode::SUCCESS) {
+                ++st.errors;
+                fail(p, res.message.c_str());
+                return;
+            }
+            p.token = res.session_token;
+            p.step = Step::IDLE;
+            if (!p.host) {
+                advance(p.pair->host);  // Guest is ready for invites
+            }
+            break;
+        }
+        case PacketType::C2S_RequestOnlineList:
+            p.step = Step::CREATE_ROOM;
+            break;
+        case PacketType::C2S_CreateRoom:
+        case PacketType::C2S_RespondInvite: {
+            S2C_CreateRoomResult res = S2C_CreateRoomResult::from_payload(payload);
+            if (res.code != ResultCode::SUCCESS) {
+                ++st.errors;
+                fail(p, res.message.c_str());
+                return;
+            }
+            p.roomId = res.room_id;
+            p.step = p.host ? Step::SEND_INVITE : Step::SET_READY;
+            break;
+        }
+        case PacketType::C2S_SendInvite:
+        case PacketType::C2S_SetReady:
+        case PacketType::C2S_StartGame: {
+            S2C_Ack ack = S2C_Ack::from_payload(payload);
+            if (ack.code != ResultCode::SUCCESS) {
+                ++st.errors;
+                fail(p, ack.message.c_str());
+                return;
+            }
+            if (request == (uint16_t)PacketType::C2S_SendInvite) {
+                p.step = Step::WAIT_JOIN;
+            } else {
+                p.step = Step::WAIT_GAME_START;
+            }
+            break;
+        }
+        case PacketType::C2S_GuessChar: {
+            S2C_GuessCharResult res = S2C_GuessCharResult::from_payload(payload);
+            bool solved = res.exposed_pattern.find('_') == std::string::npos;
+            if (solved || res.remaining_attempts == 0) {
+                p.step = p.host ? Step::END_GAME : Step::WAIT_GAME_END;
+            }
+            break;
+        }
+        case PacketType::C2S_EndGame:
+            p.step = Step::LEAVE_ROOM;
+            break;
+        case PacketType::C2S_LeaveRoom:
+            p.step = Step::HISTORY;
+            break;
+        case PacketType::C2S_RequestHistory:
+            ++p.roundsDone;
+            if (p.host) {
+                ++roundsCompleted;
+            }
+            p.step = p.roundsDone >= options.rounds ? Step::LOGOUT : Step::IDLE;
+            if (!p.host && p.step == Step::IDLE) {
+                advance(p.pair->host);
+            }
+            break;
+        case PacketType::C2S_Logout:
+            p.step = Step::DONE;
+            --active;
+            return;
+        default:
+            break;
+    }
+    advance(p);
+}
+
+void Worker::run(uint64_t deadline) {
+    for (auto& pair : pairs) {
+        advance(pair->host);
+        advance(pair->guest);
+    }
+
+    std::vector<epoll_event> events(256);
+    while (active > 0 && nowNs() < deadline) {
+        // Throttled hosts get another chance every tick
+        if (!waitingHosts.empty()) {
+            std::vector<Player*> waiting;
+            waiting.swap(waitingHosts);
+            for (Player* host : waiting) {
+                advance(*host);
+            }
+        }
+
+        int n = epoll_wait(epollFd, events.data(), (int)events.size(), 1);
+        for (int i = 0; i < n; ++i) {
+            Player& p = *static_cast<Player*>(events[i].data.ptr);
+            if (p.step == Step::FAILED) {
+                continue;
+            }
+            if (events[i].events & EPOLLOUT) {
+                flushOut(p);
+            }
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                onReadable(p);
+            }
+        }
+    }
+
+    unfinishedPlayers = active;
+    for (auto& pair : pairs) {
+        ::close(pair->host.fd);
+        ::close(pair->guest.fd);
+    }
+    ::close(epollFd);
+}
+
+const char* requestName(uint16_t type) {
+    switch ((PacketType)type) {
+        case PacketType::C2S_Register: return "C2S_Register";
+        case PacketType::C2S_Login: return "C2S_Login";
+        case PacketType::C2S_Logout: return "C2S_Logout";
+        case PacketType::C2S_CreateRoom: return "C2S_CreateRoom";
+        case PacketType::C2S_LeaveRoom: return "C2S_LeaveRoom";
+        case PacketType::C2S_RequestOnlineList: return "C2S_RequestOnlineList";
+        case PacketType::C2S_SendInvite: return "C2S_SendInvite";
+        case PacketType::C2S_RespondInvite: return "C2S_RespondInvite";
+        case PacketType::C2S_SetReady: return "C2S_SetReady";
+        case PacketType::C2S_StartGame: return "C2S_StartGame";
+        case PacketType::C2S_GuessChar: return "C2S_GuessChar";
+        case PacketType::C2S_EndGame: return "C2S_EndGame";
+        case PacketType::C2S_RequestHistory: return "C2S_RequestHistory";
+        default: return "other";
+    }
+}
+
+double percentileUs(const std::vector<uint64_t>& sorted, double q) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t idx = (size_t)(q * (sorted.size() - 1) + 0.5);
+    return sorted[idx] / 1000.0;
+}
+
+bool parseArgs(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--host") options.host = value;
+        else if (arg == "--port") options.port = std::stoi(value);
+        else if (arg == "--pairs") options.pairs = std::stoi(value);
+        else if (arg == "--threads") options.threads = std::stoi(value);
+        else if (arg == "--rounds") options.rounds = std::stoi(value);
+        else if (arg == "--rate") options.rate = std::stod(value);
+        else if (arg == "--duration") options.duration = std::stoi(value);
+        else if (arg == "--prefix") options.prefix = value;
+        else return false;
+    }
+    return options.pairs > 0 && options.threads > 0 && options.rounds > 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    try {
+        if (!parseArgs(argc, argv, options)) {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--host H] [--port P] [--pairs N] [--threads T] [--rounds R]"
+                         " [--rate ROUNDS_PER_SEC] [--duration SEC] [--prefix NAME]" << std::endl;
+            return 1;
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Invalid numeric argument" << std::endl;
+        return 1;
+    }
+    if (options.prefix.empty()) {
+        options.prefix = "bench" + std::to_string(getpid());
+    }
+    options.threads = std::min(options.threads, options.pairs);
+
+    // Two sockets per pair: make sure the fd limit allows it
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(options.port);
+    if (inet_pton(AF_INET, options.host.c_str(), &addr.sin_addr) != 1) {
+        std::cerr << "Invalid host address: " << options.host << std::endl;
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int t = 0; t < options.threads; ++t) {
+        workers.push_back(std::make_unique<Worker>(options, t, options.rate / options.threads));
+    }
+    for (int i = 0; i < options.pairs; ++i) {
+        workers[i % options.threads]->addPair(i);
+    }
+
+    std::cout << "Connecting " << options.pairs * 2 << " players to " << options.host << ":" << options.port
+              << " (" << options.threads << " threads)..." << std::endl;
+    for (auto& worker : workers) {
+        if (!worker->connectAll(addr)) {
+            return 1;
+        }
+    }
+
+    uint64_t start = nowNs();
+    uint64_t deadline = start + (uint64_t)options.duration * 1000000000ull;
+    std::vector<std::thread> threads;
+    for (auto& worker : workers) {
+        threads.emplace_back([&worker, deadline] { worker->run(deadline); });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    double elapsed = (nowNs() - start) / 1e9;
+
+    // Merge per-thread results
+    std::map<uint16_t, TypeStats> merged;
+    uint64_t rounds = 0, failed = 0, unfinished = 0, protocolErrors = 0;
+    for (auto& worker : workers) {
+        for (auto& entry : worker->stats) {
+            TypeStats& dst = merged[entry.first];
+            dst.latencies.insert(dst.latencies.end(), entry.second.latencies.begin(), entry.second.latencies.end());
+            dst.errors += entry.second.errors;
+        }
+        rounds += worker->roundsCompleted;
+        failed += worker->failedPlayers;
+        unfinished += worker->unfinishedPlayers;
+        protocolErrors += worker->protocolErrors;
+    }
+
+    uint64_t totalRequests = 0;
+    for (auto& entry : merged) {
+        totalRequests += entry.second.latencies.size();
+    }
+
+    printf("\nelapsed %.2f s, rounds %llu/%llu, requests %llu (%.0f req/s)\n", elapsed,
+           (unsigned long long)rounds, (unsigned long long)options.pairs * options.rounds,
+           (unsigned long long)totalRequests, totalRequests / elapsed);
+    printf("failed players %llu, unfinished players %llu, unexpected packets %llu\n\n",
+           (unsigned long long)failed, (unsigned long long)unfinished, (unsigned long long)protocolErrors);
+    printf("%-22s %9s %7s %10s %10s %10s %10s %10s\n", "request", "count", "errors", "req/s", "p50_us",
+           "p99_us", "p999_us", "max_us");
+    for (auto& entry : merged) {
+        std::vector<uint64_t>& lat = entry.second.latencies;
+        std::sort(lat.begin(), lat.end());
+        printf("%-22s %9zu %7llu %10.0f %10.1f %10.1f %10.1f %10.1f\n", requestName(entry.first), lat.size(),
+               (unsigned long long)entry.second.errors, lat.size() / elapsed, percentileUs(lat, 0.50),
+               percentileUs(lat, 0.99), percentileUs(lat, 0.999), lat.empty() ? 0.0 : lat.back() / 1000.0);
+    }
+
+    return (failed > 0 || unfinished > 0) ? 2 : 0;
+}
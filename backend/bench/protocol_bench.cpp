@@ -0,0 +1,200 @@
+// Protocol microbenchmark: encode (to_bytes) and decode (from_payload) cost
+// of every packet type, in ns/op and heap allocations/op.
+//
+// Decoding mirrors the server: the payload is copied into a reused
+// ByteBuffer, so only allocations made by from_payload itself are counted.
+//
+// Usage: protocol_bench [filter]   (only packets whose name contains filter)
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "protocol/packets.h"
+#include "protocol/packet_types.h"
+#include "protocol/bytebuffer.h"
+
+using namespace hangman;
+
+// ============ Allocation counting ============
+
+static size_t g_allocations = 0;
+
+void* operator new(size_t size) {
+    ++g_allocations;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+// Keep the optimizer from discarding benchmark results
+template <typename T>
+void escape(T* p) {
+    asm volatile("" : : "g"(p) : "memory");
+}
+
+uint64_t nowNs() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+struct Result {
+    double nsPerOp;
+    double allocsPerOp;
+};
+
+// Run fn in growing batches until one batch takes at least 50 ms
+template <typename Fn>
+Result measure(Fn&& fn) {
+    fn();  // Warm up (first-use allocations, caches)
+    size_t iterations = 16;
+    while (true) {
+        size_t allocsBefore = g_allocations;
+        uint64_t start = nowNs();
+        for (size_t i = 0; i < iterations; ++i) {
+            fn();
+        }
+        uint64_t elapsed = nowNs() - start;
+        if (elapsed >= 50000000ull || iterations >= (1u << 26)) {
+            return {(double)elapsed / iterations, (double)(g_allocations - allocsBefore) / iterations};
+        }
+        iterations *= elapsed < 5000000ull ? 8 : 2;
+    }
+}
+
+const char* g_filter = nullptr;
+
+template <typename P>
+void benchPacket(const char* name, const P& sample) {
+    if (g_filter && std::string(name).find(g_filter) == std::string::npos) {
+        return;
+    }
+
+    std::vector<uint8_t> bytes = sample.to_bytes();
+
+    Result encode = measure([&] {
+        std::vector<uint8_t> out = sample.to_bytes();
+        escape(out.data());
+    });
+
+    ByteBuffer bb;
+    Result decode = measure([&] {
+        bb.buf.assign(bytes.begin() + PacketHeader::HEADER_SIZE, bytes.end());
+        bb.rpos = 0;
+        P packet = P::from_payload(bb);
+        escape(&packet);
+    });
+
+    printf("%-34s %8zu %12.1f %10.2f %12.1f %10.2f\n", name, bytes.size(), encode.nsPerOp, encode.allocsPerOp,
+           decode.nsPerOp, decode.allocsPerOp);
+}
+
+// Session tokens are 16 opaque bytes
+std::string token() { return std::string(16, 't'); }
+
+std::string user(size_t i) { return "player_" + std::to_string(i); }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        g_filter = argv[1];
+    }
+
+    printf("%-34s %8s %12s %10s %12s %10s\n", "packet", "bytes", "enc_ns/op", "enc_alloc", "dec_ns/op", "dec_alloc");
+
+    // Authentication
+    benchPacket("C2S_Register", C2S_Register{"player_one", "secret_password"});
+    benchPacket("S2C_RegisterResult", S2C_RegisterResult{ResultCode::SUCCESS, "Registration successful"});
+    benchPacket("C2S_Login", C2S_Login{"player_one", "secret_password"});
+    benchPacket("S2C_LoginResult", S2C_LoginResult{ResultCode::SUCCESS, "Login successful", token(), 12, 340});
+    benchPacket("C2S_Logout", C2S_Logout{token()});
+    benchPacket("S2C_LogoutAck", S2C_LogoutAck{ResultCode::SUCCESS, "Logged out"});
+    benchPacket("C2S_ResumeSession", C2S_ResumeSession{token()});
+    benchPacket("S2C_ResumeResult", S2C_ResumeResult{ResultCode::SUCCESS, "Session resumed", "player_one", 12, 340});
+
+    // Lobby / room
+    benchPacket("C2S_CreateRoom", C2S_CreateRoom{token(), "Friday night room"});
+    benchPacket("S2C_CreateRoomResult", S2C_CreateRoomResult{ResultCode::SUCCESS, "Room created", 42});
+    benchPacket("C2S_LeaveRoom", C2S_LeaveRoom{token(), 42});
+    benchPacket("S2C_LeaveRoomAck", S2C_LeaveRoomAck{ResultCode::SUCCESS, "Left room"});
+    benchPacket("S2C_PlayerLeftNotification", S2C_PlayerLeftNotification{"player_two", true, "player_two left the room"});
+    benchPacket("C2S_RequestOnlineList", C2S_RequestOnlineList{token()});
+    benchPacket("C2S_KickPlayer", C2S_KickPlayer{token(), 42, "player_two"});
+    benchPacket("S2C_KickResult", S2C_KickResult{ResultCode::SUCCESS, "Kick success"});
+
+    S2C_OnlineList onlineSmall;
+    for (size_t i = 0; i < 10; ++i) {
+        onlineSmall.users.push_back(user(i));
+    }
+    benchPacket("S2C_OnlineList (10 users)", onlineSmall);
+
+    S2C_OnlineList onlineLarge;
+    for (size_t i = 0; i < 1000; ++i) {
+        onlineLarge.users.push_back(user(i) + "_with_a_long_name");
+    }
+    benchPacket("S2C_OnlineList (1000 users)", onlineLarge);
+
+    // Invite / ready / start
+    benchPacket("C2S_SendInvite", C2S_SendInvite{token(), "player_two", 42});
+    benchPacket("S2C_InviteReceived", S2C_InviteReceived{"player_one", 42});
+    benchPacket("C2S_RespondInvite", C2S_RespondInvite{token(), "player_one", true});
+    benchPacket("S2C_InviteResponse", S2C_InviteResponse{"player_one", true, "player_two accepted invite"});
+    benchPacket("C2S_SetReady", C2S_SetReady{token(), 42, true});
+    benchPacket("S2C_PlayerReadyUpdate", S2C_PlayerReadyUpdate{"player_two", true});
+    benchPacket("C2S_StartGame", C2S_StartGame{token(), 42});
+    benchPacket("S2C_GameStart", S2C_GameStart{42, "player_two", 7});
+
+    // Game actions
+    benchPacket("C2S_GuessChar", C2S_GuessChar{token(), 42, 42, 'A'});
+    benchPacket("S2C_GuessCharResult", S2C_GuessCharResult{true, "_ A _ _ _ A _", 5});
+    benchPacket("C2S_GuessWord", C2S_GuessWord{token(), 42, 42, "HANGMAN"});
+    benchPacket("S2C_GuessWordResult", S2C_GuessWordResult{true, "Correct!", 5});
+    benchPacket("C2S_RequestDraw", C2S_RequestDraw{token(), 42, 42});
+    benchPacket("S2C_DrawRequest", S2C_DrawRequest{"player_one", 42});
+    benchPacket("C2S_EndGame", C2S_EndGame{token(), 42, 42, 1, "Well played"});
+    benchPacket("S2C_GameEnd", S2C_GameEnd{42, 1, "Game Over"});
+
+    // Records / leaderboard
+    benchPacket("C2S_RequestHistory", C2S_RequestHistory{token()});
+    benchPacket("C2S_RequestLeaderboard", C2S_RequestLeaderboard{token()});
+
+    S2C_HistoryList historySmall;
+    S2C_HistoryList historyLarge;
+    for (uint32_t i = 0; i < 500; ++i) {
+        S2C_HistoryList::Entry entry{i, user(i), (uint8_t)(i % 4), 1700000000u + i, "Opponent resigned early"};
+        if (i < 10) {
+            historySmall.entries.push_back(entry);
+        }
+        historyLarge.entries.push_back(entry);
+    }
+    benchPacket("S2C_HistoryList (10 entries)", historySmall);
+    benchPacket("S2C_HistoryList (500 entries)", historyLarge);
+
+    S2C_Leaderboard leaderboardSmall;
+    S2C_Leaderboard leaderboardLarge;
+    for (uint32_t i = 0; i < 1000; ++i) {
+        S2C_Leaderboard::Row row{user(i), 1000 - i, i / 2, i % 7};
+        if (i < 10) {
+            leaderboardSmall.rows.push_back(row);
+        }
+        leaderboardLarge.rows.push_back(row);
+    }
+    benchPacket("S2C_Leaderboard (10 rows)", leaderboardSmall);
+    benchPacket("S2C_Leaderboard (1000 rows)", leaderboardLarge);
+
+    // Generic
+    benchPacket("S2C_Ack", S2C_Ack{(uint16_t)PacketType::C2S_SendInvite, ResultCode::SUCCESS, "Invite sent"});
+    benchPacket("S2C_Error", S2C_Error{(uint16_t)PacketType::C2S_GuessChar, "Match not found or ended"});
+
+    return 0;
+}
@@ -0,0 +1,317 @@
+// Service-level benchmark: calls the service singletons in-process from N
+// threads against a synthetic population, without sockets, the event loop or
+// the task queue. Shows lock contention and how each call scales with threads.
+//
+// Population is built through the public service API: users are loaded from a
+// generated database file, sessions come from login(), every room gets a host
+// and a guest and a running match.
+//
+// Usage: service_bench [--users N] [--sessions N] [--rooms N] [--threads N]
+//                      [--duration SEC] [--ops name,name]
+// Threads are stepped 1, 2, 4, ... up to --threads for every operation.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "service/AuthService.h"
+#include "service/BeforePlayService.h"
+#include "service/MatchService.h"
+#include "service/RoomService.h"
+#include "service/SummaryService.h"
+#include "util/Logger.h"
+#include "util/PasswordHash.h"
+
+using namespace hangman;
+
+namespace {
+
+struct Options {
+    size_t users = 100000;
+    size_t sessions = 10000;
+    size_t rooms = 5000;
+    size_t maxThreads = 8;
+    double duration = 2.0;
+    std::string ops = "validateSession,getOnlineList,guessChar,getLeaderboard";
+};
+
+struct Population {
+    std::string dbPath;                  // Generated user file (removed on exit)
+    std::vector<std::string> tokens;     // One per logged-in user
+    std::vector<uint32_t> roomIds;       // Room i: host tokens[2i], guest tokens[2i+1]
+};
+
+const char* WORDS[] = {"HANGMAN", "NETWORK", "PROTOCOL", "SOCKET", "THREAD", "SERVER"};
+constexpr size_t WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+uint64_t nowNs() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+std::string userName(size_t i) { return "bench_user_" + std::to_string(i); }
+
+bool parseOptions(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            fprintf(stderr, "Missing value for %s\n", arg.c_str());
+            return false;
+        }
+        const char* value = argv[++i];
+        if (arg == "--users") opt.users = strtoull(value, nullptr, 10);
+        else if (arg == "--sessions") opt.sessions = strtoull(value, nullptr, 10);
+        else if (arg == "--rooms") opt.rooms = strtoull(value, nullptr, 10);
+        else if (arg == "--threads") opt.maxThreads = strtoull(value, nullptr, 10);
+        else if (arg == "--duration") opt.duration = atof(value);
+        else if (arg == "--ops") opt.ops = value;
+        else {
+            fprintf(stderr, "Unknown option %s\n", arg.c_str());
+            return false;
+        }
+    }
+    opt.sessions = std::min(opt.sessions, opt.users);
+    opt.rooms = std::min(opt.rooms, opt.sessions / 2);
+    if (opt.sessions == 0 || opt.maxThreads == 0 || opt.duration <= 0) {
+        fprintf(stderr, "sessions, threads and duration must be positive\n");
+        return false;
+    }
+    return true;
+}
+
+bool buildPopulation(const Options& opt, Population& pop) {
+    uint64_t start = nowNs();
+
+    // Users: write a database file in the server's format and load it
+    char dbPath[] = "/tmp/hangman_service_bench_XXXXXX";
+    int fd = mkstemp(dbPath);
+    if (fd < 0) {
+        perror("mkstemp");
+        return false;
+    }
+    pop.dbPath = dbPath;
+
+    // Entries are already hashed (one shared hash at the cheapest cost): logins
+    // have nothing to upgrade, and hashing is not measured here
+    std::string hash = PasswordHash::hash("pw", 1);
+    FILE* db = fdopen(fd, "w");
+    std::mt19937 rng(42);
+    for (size_t i = 0; i < opt.users; ++i) {
+        fprintf(db, "%s:%s:%u:%u\n", userName(i).c_str(), hash.c_str(), (unsigned)(rng() % 100),
+                (unsigned)(rng() % 10000));
+    }
+    fclose(db);
+    if (!AuthService::getInstance().loadDatabase(dbPath)) {
+        fprintf(stderr, "Failed to load generated database\n");
+        return false;
+    }
+
+    // Sessions (fd = index, nothing is ever sent)
+    pop.tokens.reserve(opt.sessions);
+    for (size_t i = 0; i < opt.sessions; ++i) {
+        C2S_Login login{userName(i), "pw"};
+        S2C_LoginResult res = AuthService::getInstance().login(login, (int)(1000 + i));
+        if (res.code != ResultCode::SUCCESS) {
+            fprintf(stderr, "Login failed for %s: %s\n", login.username.c_str(), res.message.c_str());
+            return false;
+        }
+        pop.tokens.push_back(res.session_token);
+    }
+
+    // Rooms: host + guest, match started
+    pop.roomIds.reserve(opt.rooms);
+    for (size_t i = 0; i < opt.rooms; ++i) {
+        C2S_CreateRoom create{pop.tokens[2 * i], "room_" + std::to_string(i)};
+        S2C_CreateRoomResult res = RoomService::getInstance().createRoom(create, (int)(1000 + 2 * i));
+        if (res.code != ResultCode::SUCCESS) {
+            fprintf(stderr, "CreateRoom failed: %s\n", res.message.c_str());
+            return false;
+        }
+        RoomService::getInstance().joinRoom(res.room_id, userName(2 * i + 1), (int)(1000 + 2 * i + 1));
+        MatchService::getInstance().startMatch(res.room_id, {userName(2 * i), userName(2 * i + 1)},
+                                               WORDS[i % WORD_COUNT]);
+        pop.roomIds.push_back(res.room_id);
+    }
+
+    printf("population: users=%zu sessions=%zu rooms=%zu matches=%zu (built in %.1f s)\n", opt.users,
+           pop.tokens.size(), pop.roomIds.size(), pop.roomIds.size(), (nowNs() - start) / 1e9);
+    return true;
+}
+
+// Per-thread state handed to every call
+struct Worker {
+    size_t index;
+    size_t count;
+    std::mt19937 rng;
+    size_t lastRoom = 0;  // Room used by the last guessChar
+};
+
+// One benchmarked call; returns false if the call failed
+using Operation = bool (*)(const Population& pop, Worker& worker);
+
+bool opValidateSession(const Population& pop, Worker& worker) {
+    std::string username;
+    return AuthService::getInstance().validateSession(pop.tokens[worker.rng() % pop.tokens.size()], username);
+}
+
+bool opGetOnlineList(const Population& pop, Worker& worker) {
+    C2S_RequestOnlineList request{pop.tokens[worker.rng() % pop.tokens.size()]};
+    S2C_OnlineList list = BeforePlayService::getInstance().getOnlineList(request);
+    return true;
+}
+
+// Each thread plays its own slice of rooms so threads do not finish each
+// other's matches
+bool opGuessChar(const Population& pop, Worker& worker) {
+    size_t slice = (pop.roomIds.size() + worker.count - 1) / worker.count;
+    size_t first = std::min(worker.index * slice, pop.roomIds.size());
+    size_t count = std::min(slice, pop.roomIds.size() - first);
+    if (count == 0) {
+        worker.lastRoom = SIZE_MAX;  // More threads than rooms
+        return false;
+    }
+    size_t room = first + worker.rng() % count;
+    worker.lastRoom = room;
+    C2S_GuessChar request{pop.tokens[2 * room], pop.roomIds[room], pop.roomIds[room],
+                          (char)('A' + worker.rng() % 26)};
+    return MatchService::getInstance().guessChar(request).success;
+}
+
+bool opGetLeaderboard(const Population& pop, Worker& worker) {
+    C2S_RequestLeaderboard request{pop.tokens[worker.rng() % pop.tokens.size()]};
+    return !SummaryService::getInstance().getLeaderboard(request).rows.empty();
+}
+
+void restartMatch(const Population& pop, size_t room) {
+    MatchService::getInstance().startMatch(pop.roomIds[room], {userName(2 * room), userName(2 * room + 1)},
+                                           WORDS[room % WORD_COUNT]);
+}
+
+struct ThreadResult {
+    std::vector<uint64_t> samples;
+    size_t errors = 0;
+};
+
+void runPoint(const char* name, Operation op, const Population& pop, size_t threadCount, double duration) {
+    std::vector<ThreadResult> results(threadCount);
+    std::vector<std::thread> threads;
+    std::atomic<size_t> readyCount{0};
+    std::atomic<bool> go{false};
+    uint64_t durationNs = (uint64_t)(duration * 1e9);
+    bool isGuess = op == opGuessChar;
+
+    for (size_t t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&, t] {
+            Worker worker{t, threadCount, std::mt19937((unsigned)(t * 7919 + 1))};
+            ThreadResult& out = results[t];
+            out.samples.reserve(1 << 16);
+            readyCount.fetch_add(1);
+            while (!go.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            uint64_t deadline = nowNs() + durationNs;
+            while (true) {
+                uint64_t begin = nowNs();
+                bool ok = op(pop, worker);
+                uint64_t end = nowNs();
+                if (!ok && isGuess && worker.lastRoom < pop.roomIds.size()) {
+                    // Player finished the match: restart it outside the timed call
+                    restartMatch(pop, worker.lastRoom);
+                } else if (!ok) {
+                    ++out.errors;
+                }
+                out.samples.push_back(end - begin);
+                if (end >= deadline) {
+                    break;
+                }
+            }
+        });
+    }
+    while (readyCount.load() < threadCount) {
+        std::this_thread::yield();
+    }
+    uint64_t start = nowNs();
+    go.store(true, std::memory_order_release);
+    for (auto& th : threads) {
+        th.join();
+    }
+    double elapsed = (nowNs() - start) / 1e9;
+
+    std::vector<uint64_t> all;
+    size_t errors = 0;
+    for (auto& r : results) {
+        all.insert(all.end(), r.samples.begin(), r.samples.end());
+        errors += r.errors;
+    }
+    std::sort(all.begin(), all.end());
+    auto pct = [&](double q) {
+        size_t idx = (size_t)(q * (all.size() - 1));
+        return all[idx] / 1000.0;
+    };
+    printf("%-16s %7zu %10zu %7zu %12.1f %12.1f %12.1f %12.1f\n", name, threadCount, all.size(), errors,
+           all.size() / elapsed, pct(0.50), pct(0.99), all.back() / 1000.0);
+    fflush(stdout);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) {
+        return 1;
+    }
+
+    // Keep per-room/per-match INFO logs out of the measurements
+    Logger::getInstance().setLevel(LogLevel::WARN);
+
+    // Finished matches update stats and rewrite the user file: the path stays
+    // valid while the benchmark runs and is removed at the end
+    Population pop;
+    if (!buildPopulation(opt, pop)) {
+        if (!pop.dbPath.empty()) {
+            unlink(pop.dbPath.c_str());
+        }
+        return 1;
+    }
+
+    struct Entry {
+        const char* name;
+        Operation op;
+    };
+    const Entry entries[] = {
+        {"validateSession", opValidateSession},
+        {"getOnlineList", opGetOnlineList},
+        {"guessChar", opGuessChar},
+        {"getLeaderboard", opGetLeaderboard},
+    };
+
+    printf("%-16s %7s %10s %7s %12s %12s %12s %12s\n", "operation", "threads", "ops", "errors", "ops/s",
+           "p50_us", "p99_us", "max_us");
+    for (const Entry& entry : entries) {
+        if (("," + opt.ops + ",").find(std::string(",") + entry.name + ",") == std::string::npos) {
+            continue;
+        }
+        if (entry.op == opGuessChar && pop.roomIds.empty()) {
+            printf("%-16s skipped (no rooms)\n", entry.name);
+            continue;
+        }
+        for (size_t threads = 1;; threads *= 2) {
+            size_t n = std::min(threads, opt.maxThreads);
+            runPoint(entry.name, entry.op, pop, n, opt.duration);
+            if (n == opt.maxThreads) {
+                break;
+            }
+        }
+    }
+    unlink(pop.dbPath.c_str());
+    return 0;
+}
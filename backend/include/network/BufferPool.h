@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace hangman {
+
+// Fixed-size I/O block lent to a connection while it has data in flight
+struct BufferBlock {
+    static constexpr size_t SIZE = 8192;  // Power of two (receive ring relies on it)
+
+    uint8_t data[SIZE];
+};
+
+// Pool of BufferBlocks shared by all connections.
+// Network thread only: no locking.
+class BufferPool {
+public:
+    static BufferPool& getInstance();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // Get an empty block (from the free list, or freshly allocated)
+    BufferBlock* acquire();
+
+    // Return a block; kept for reuse up to maxCachedBlocks, freed beyond that
+    void release(BufferBlock* block);
+
+    // Free blocks kept around to absorb bursts without hitting malloc
+    void setMaxCachedBlocks(size_t count);
+
+    size_t blocksInUse() const { return inUse; }
+    size_t blocksCached() const { return freeList.size(); }
+
+    static constexpr size_t DEFAULT_MAX_CACHED_BLOCKS = 256;  // 2 MB
+
+private:
+    BufferPool() = default;
+    ~BufferPool();
+
+    std::vector<BufferBlock*> freeList;
+    size_t maxCachedBlocks = DEFAULT_MAX_CACHED_BLOCKS;
+    size_t inUse = 0;
+};
+
+} // namespace hangman
@@ -1,55 +1,178 @@
 #pragma once
 
+#include "network/RingBuffer.h"
+#include "network/BufferPool.h"
+#include "network/SharedPacket.h"
+#include <deque>
 #include <vector>
 #include <cstdint>
+#include <cstddef>
 #include <memory>
+#include <string>
+#include <sys/uio.h>
 
 namespace hangman {
 
+// Per-connection send queue limits (bytes of queued, not-yet-written data)
+struct SendLimits {
+    size_t highWatermark = 64 * 1024;   // Stop reading from the client above this
+    size_t lowWatermark = 16 * 1024;    // Resume reading once drained below this
+    size_t hardLimit = 1024 * 1024;     // Drop the client above this
+};
+
+// A complete packet sitting in the receive ring
+struct PacketView {
+    uint8_t version;
+    uint16_t type;
+    const uint8_t* payload;  // Valid until confirmProcessed()
+    uint32_t payloadLen;
+    uint32_t requestId;      // v2 header only, 0 otherwise
+    size_t headerSize;       // Header bytes in front of the payload
+};
+
 class Connection {
 public:
     explicit Connection(int clientFd);
     ~Connection();
 
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    // Connections are carved out of a slab (network thread only). Other
+    // sizes (a derived class) go to the global heap; the sized delete sends
+    // each pointer back where it came from.
+    static void* operator new(size_t size);
+    static void operator delete(void* p, size_t size);
+    static size_t liveConnections();
+
+    // Unique for the server's lifetime (fd numbers are reused after close):
+    // results of a task only go to the connection that sent the request
+    uint64_t id() const { return connectionId; }
+
     // Socket management
     int getFd() const { return clientFd; }
     void close();
     bool isClosed() const { return clientFd < 0; }
 
+    // Peer IPv4 address (network byte order), set at accept time
+    uint32_t getPeerAddress() const { return peerAddress; }
+    void setPeerAddress(uint32_t addr) { peerAddress = addr; }
+
     // Sending data - returns true if all sent, false if partial/pending
+    // Data that cannot be written right away is copied into pooled blocks
+    // chained behind each other, so queued bytes are never moved once appended.
     bool sendData(const uint8_t* data, size_t len);
-    
-    // Get pending data to send (returns pointer and size)
-    const uint8_t* getPendingSendData(size_t& outLen) const;
-    
-    // Confirm bytes sent
-    void confirmSent(size_t bytes);
-    
-    // Receiving data - reads from socket into buffer
+
+    // Same as sendData for a packet shared with other connections: whatever
+    // cannot be written right away is queued by reference, not copied.
+    bool sendShared(const SharedPacket& packet);
+
+    // Send header followed by body in one write. The body is queued by
+    // reference when it lies inside owner, copied otherwise. Used to re-frame
+    // an encoded packet (v2 header in front of its payload).
+    bool sendFramed(const uint8_t* header, size_t headerLen, const uint8_t* body, size_t bodyLen,
+                    const SharedPacket* owner);
+
+    // Write as much queued data as the socket accepts.
+    // Returns false on a fatal socket error (connection is closed).
+    bool flush();
+
+    // Bytes queued but not yet written
+    size_t pendingSendBytes() const { return sendQueued; }
+    bool hasPendingSend() const { return sendQueued > 0; }
+
+    // Backpressure: reading is paused while the send queue is too large
+    bool isReadPaused() const { return readPaused; }
+    void setReadPaused(bool paused) { readPaused = paused; }
+
+    // Close as soon as the send queue drains (one-shot replies, e.g. admin dump)
+    bool isCloseAfterFlush() const { return closeAfterFlush; }
+    void setCloseAfterFlush(bool close) { closeAfterFlush = close; }
+
+    // Requests handed to the worker whose results are not delivered yet.
+    // Inline requests only run when this is 0, so replies stay in order.
+    uint32_t getTasksInFlight() const { return tasksInFlight; }
+    void taskQueued() { ++tasksInFlight; }
+    void taskDelivered() { if (tasksInFlight > 0) --tasksInFlight; }
+
+    // Highest header version the client has used; pushes are framed in it
+    uint8_t getProtocolVersion() const { return protocolVersion; }
+    void setProtocolVersion(uint8_t version) { protocolVersion = version; }
+
+    // Session bound after a successful login on this connection. Requests
+    // with an empty token run as this user without a session table lookup.
+    bool hasSession() const { return !sessionUser.empty(); }
+    const std::string& getSessionUser() const { return sessionUser; }
+    const std::string& getSessionToken() const { return sessionToken; }
+    void bindSession(const std::string& username, const std::string& token) {
+        sessionUser = username;
+        sessionToken = token;
+    }
+    void releaseSession() {
+        sessionUser.clear();
+        sessionToken.clear();
+    }
+
+    // Events currently registered with the EventLoop for this fd
+    uint32_t getRegisteredEvents() const { return registeredEvents; }
+    void setRegisteredEvents(uint32_t events) { registeredEvents = events; }
+
+    // Receiving data - reads from socket until EAGAIN or the ring is full.
+    // Returns false if the peer closed or the socket failed.
     bool receiveData();
-    
-    // Get received data available for processing
-    const uint8_t* getReceivedData(size_t& outLen) const;
-    
+
+    // True if the last receiveData() stopped because the ring ran out of space
+    bool isReceiveBufferFull() const { return recvRing.full(); }
+
+    // Frame the next complete packet (handles wraparound).
+    // Returns false if more bytes are needed; throws on a packet that can never fit.
+    bool peekPacket(PacketView& out);
+
     // Mark bytes as processed
     void confirmProcessed(size_t bytes);
-    
-    // Check if we have a complete packet (need at least header size)
-    bool hasCompletePacket() const;
 
-    // Buffer sizes
-    static constexpr size_t RECV_BUFFER_SIZE = 8192;
-    static constexpr size_t SEND_BUFFER_SIZE = 8192;
+    // Buffer sizes (blocks are lent by the BufferPool while data is in flight)
+    static constexpr size_t RECV_BUFFER_SIZE = RingBuffer::capacity();
+    static constexpr size_t HEADER_SIZE = 1 + 2 + 4;
+    static constexpr size_t MAX_HEADER_SIZE = HEADER_SIZE + 4;  // v2 adds the request id
+
+    // Max blocks handed to a single writev() call
+    static constexpr int MAX_IOV = 16;
 
 private:
     int clientFd;
-    std::vector<uint8_t> recvBuffer;
-    size_t recvPos = 0;  // Position of unprocessed data
-    
-    std::vector<uint8_t> sendBuffer;
-    size_t sendPos = 0;  // Position of unsent data
+    uint64_t connectionId;
+    uint32_t peerAddress = 0;
+    RingBuffer recvRing;
+    std::vector<uint8_t> recvScratch;  // Reassembles payloads that wrap the ring
+
+    // Write directly when nothing is queued; returns bytes written (may be 0).
+    // Throws on a fatal socket error.
+    size_t writeDirect(const uint8_t* data, size_t len);
+    size_t writeDirectv(const iovec* iov, int iovCount);
+    void appendToSendQueue(const uint8_t* data, size_t len);
+
+    // Send queue entry: bytes copied into a pooled block, or a reference to a
+    // shared packet. [begin, end) is the unsent range.
+    struct SendSegment {
+        BufferBlock* block;   // nullptr for shared segments
+        SharedPacket shared;
+        size_t begin;
+        size_t end;
+        const uint8_t* bytes() const { return block ? block->data : shared->data(); }
+    };
+    std::deque<SendSegment> sendQueue;  // Oldest first
+    size_t sendQueued = 0;              // Total unsent bytes across all segments
+
+    bool readPaused = false;
+    bool closeAfterFlush = false;
+    uint32_t tasksInFlight = 0;
+    uint32_t registeredEvents = 0;
+    uint8_t protocolVersion = 1;
+    std::string sessionUser;
+    std::string sessionToken;
 };
 
-using ConnectionPtr = std::shared_ptr<Connection>;
+using ConnectionPtr = std::unique_ptr<Connection>;
 
 } // namespace hangman
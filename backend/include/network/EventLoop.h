@@ -1,13 +1,15 @@
 // include/network/EventLoop.h
 #pragma once
 #include <functional>
-#include <map>
+#include <vector>
 #include <atomic>
 #include <cstdint>
 
 class EventLoop {
 public:
-    using EventCallback = std::function<void()>;
+    // Called with the ready events (EVENT_READ | EVENT_WRITE); hangup and
+    // errors are reported as EVENT_READ so the next read observes them
+    using EventCallback = std::function<void(uint32_t events)>;
     
     // Event types
     static constexpr uint32_t EVENT_READ = 1;
@@ -20,6 +22,10 @@ public:
     void addFd(int fd, EventCallback callback, uint32_t events = EVENT_READ);
     void removeFd(int fd);
     void modifyFd(int fd, uint32_t events);
+
+    // Periodic timer (timerfd) run on the loop thread; returns the timer fd
+    int addTimer(uint32_t intervalMs, std::function<void()> callback);
+    void removeTimer(int timerFd);
     
     // Chạy event loop
     void run();
@@ -28,7 +34,7 @@ public:
 private:
     int epollFd;
     std::atomic<bool> running;
-    std::map<int, EventCallback> callbacks;
+    std::vector<EventCallback> callbacks;  // Indexed by fd (dense, no lookup)
     
     static constexpr int MAX_EVENTS = 64;
 };
\ No newline at end of file
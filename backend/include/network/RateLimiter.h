@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+namespace hangman {
+
+// Token-bucket rate limiter keyed by Key (peer address, username, ...).
+// Each key gets `burst` tokens refilled at `ratePerSec`; a request takes one.
+// Idle buckets that have refilled completely are dropped on a periodic sweep,
+// so memory follows the number of recently active keys.
+// Not thread-safe; meant for the network thread.
+template <typename Key>
+class RateLimiter {
+public:
+    RateLimiter(double ratePerSec, double burst) : ratePerSec(ratePerSec), burst(burst) {}
+
+    // Take one token for key; false if its bucket is empty.
+    // A non-positive rate disables the limiter.
+    bool allow(const Key& key, uint64_t nowNs) {
+        if (ratePerSec <= 0) {
+            return true;
+        }
+        auto it = buckets.find(key);
+        if (it == buckets.end()) {
+            if (buckets.size() >= sweepAt) {
+                sweep(nowNs);
+            }
+            it = buckets.emplace(key, Bucket{burst, nowNs}).first;
+        }
+        Bucket& bucket = it->second;
+        refill(bucket, nowNs);
+        if (bucket.tokens < 1.0) {
+            return false;
+        }
+        bucket.tokens -= 1.0;
+        return true;
+    }
+
+    size_t size() const { return buckets.size(); }
+
+private:
+    struct Bucket {
+        double tokens;
+        uint64_t updatedAt;
+    };
+
+    void refill(Bucket& bucket, uint64_t nowNs) {
+        double tokens = bucket.tokens + (double)(nowNs - bucket.updatedAt) * ratePerSec / 1e9;
+        bucket.tokens = tokens < burst ? tokens : burst;
+        bucket.updatedAt = nowNs;
+    }
+
+    // Drop buckets back at full burst (same as a fresh one); next sweep when
+    // the table has doubled again, so the cost is amortized per insert
+    void sweep(uint64_t nowNs) {
+        for (auto it = buckets.begin(); it != buckets.end();) {
+            refill(it->second, nowNs);
+            if (it->second.tokens >= burst) {
+                it = buckets.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        sweepAt = buckets.size() * 2 > MIN_SWEEP ? buckets.size() * 2 : MIN_SWEEP;
+    }
+
+    static constexpr size_t MIN_SWEEP = 1024;
+
+    double ratePerSec;
+    double burst;
+    std::unordered_map<Key, Bucket> buckets;
+    size_t sweepAt = MIN_SWEEP;
+};
+
+} // namespace hangman
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "network/BufferPool.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <sys/types.h>
+
+namespace hangman {
+
+// Fixed-capacity byte ring backed by one pooled BufferBlock.
+// head/tail grow monotonically and are masked on access, so the buffer
+// never compacts. The block is borrowed from the BufferPool only while
+// there are unconsumed bytes, so an idle connection holds no buffer.
+class RingBuffer {
+public:
+    RingBuffer() = default;
+    ~RingBuffer();
+
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+
+    static constexpr size_t capacity() { return BufferBlock::SIZE; }
+    size_t size() const { return tail - head; }
+    size_t freeSpace() const { return capacity() - size(); }
+    bool empty() const { return head == tail; }
+    bool full() const { return size() == capacity(); }
+    bool hasStorage() const { return block != nullptr; }
+
+    // Read from fd straight into the free space (one readv, up to two spans).
+    // Returns bytes read, 0 on EOF, -1 on error (errno is preserved).
+    ssize_t readFrom(int fd);
+
+    // Copy len bytes starting offset bytes past head into dst
+    void peek(size_t offset, uint8_t* dst, size_t len) const;
+
+    // View of len bytes starting offset bytes past head. Points into the ring
+    // when the range does not wrap, otherwise into scratch (capacity reused).
+    const uint8_t* contiguous(size_t offset, size_t len, std::vector<uint8_t>& scratch) const;
+
+    // Drop len bytes from the front (returns the block to the pool once empty)
+    void consume(size_t len);
+
+private:
+    static_assert((BufferBlock::SIZE & (BufferBlock::SIZE - 1)) == 0,
+                  "RingBuffer capacity must be a power of two");
+    static constexpr size_t MASK = BufferBlock::SIZE - 1;
+
+    void releaseIfEmpty();
+
+    BufferBlock* block = nullptr;
+    size_t head = 0;  // Read index (unmasked)
+    size_t tail = 0;  // Write index (unmasked)
+};
+
+} // namespace hangman
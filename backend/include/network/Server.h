@@ -2,20 +2,85 @@
 
 #include "network/EventLoop.h"
 #include "network/Connection.h"
+#include "network/SharedPacket.h"
+#include "network/RateLimiter.h"
 #include "threading/TaskQueue.h"
 #include "threading/CallbackQueue.h"
-#include <map>
+#include "protocol/bytebuffer.h"
+#include "util/PasswordHash.h"
+#include <string>
+#include <vector>
 #include <memory>
 #include <thread>
 #include <atomic>
+#include <deque>
+#include <unordered_map>
 
 namespace hangman
 {
 
+    // Tunables for the network layer
+    struct ServerConfig
+    {
+        SendLimits sendLimits;
+
+        // Accepted socket options
+        bool tcpNoDelay = true;        // Responses are small and latency-bound
+        int socketSendBuffer = 0;      // SO_SNDBUF in bytes, 0 = kernel default
+        int socketRecvBuffer = 0;      // SO_RCVBUF in bytes, 0 = kernel default
+        int deferAcceptSeconds = 0;    // TCP_DEFER_ACCEPT, 0 = disabled
+
+        // Plain-text status dump on 127.0.0.1:adminPort (0 = disabled)
+        int adminPort = 0;
+
+        // Worker pool size. Lobby tasks run on one actor at a time; match
+        // actions of different rooms run in parallel.
+        size_t workerThreads = 4;
+
+        // Max tasks a worker runs per wakeup before publishing their results
+        // in one callback. Larger batches amortize locks and eventfd writes
+        // but delay the first response of the batch.
+        size_t workerBatchSize = 32;
+
+        // Auth pool for login/register (password hashing). Requests beyond
+        // authQueueLimit queued ones are answered "Server busy" right away.
+        size_t authThreads = 2;
+        size_t authQueueLimit = 256;
+        uint32_t passwordIterations = PasswordHash::DEFAULT_ITERATIONS;
+
+        // Login/register rate limits (token buckets: tokens per second and
+        // burst), checked on the network thread before a task is created.
+        // Rate 0 = unlimited. Loopback peers (tests, benchmarks) skip the
+        // per-address limit unless limitLoopback is set.
+        double authPerAddressRate = 2.0;
+        double authPerAddressBurst = 10.0;
+        double loginPerUserRate = 0.2;
+        double loginPerUserBurst = 5.0;
+        bool limitLoopback = false;
+
+        // Sessions, rooms and matches are snapshotted to snapshotPath every
+        // snapshotIntervalSec seconds and on shutdown, and restored on startup.
+        // Empty path disables snapshots; interval 0 keeps only the shutdown one.
+        std::string snapshotPath = "database/state.snapshot";
+        uint32_t snapshotIntervalSec = 30;
+
+        // A logged-in client whose connection drops can resume its session
+        // (C2S_ResumeSession) within resumeGraceSec seconds; up to
+        // resumeOutboxLimit notifications sent meanwhile are replayed, older
+        // ones are dropped. Unresumed sessions are logged out.
+        uint32_t resumeGraceSec = 60;
+        size_t resumeOutboxLimit = 16;
+
+        // Account file changes that are not urgent (password hashes upgraded
+        // at login) are written at most once per userFlushIntervalSec seconds
+        // and on shutdown
+        uint32_t userFlushIntervalSec = 5;
+    };
+
     class Server
     {
     public:
-        explicit Server(int port);
+        explicit Server(int port, const ServerConfig &config = ServerConfig());
         ~Server();
 
         // Initialize server (load database and prepare)
@@ -35,34 +100,88 @@ namespace hangman
     private:
         // Network thread handlers
         void handleAccept();
+        void handleClientEvent(int clientFd, uint32_t events);
         void handleClientRead(int clientFd);
         void handleClientWrite(int clientFd);
         void handleCallbacks();
+        void handleAdminAccept();
+
+        // Worker thread main loop (game workers and auth pool)
+        void workerThreadLoop(TaskQueue &queue);
 
-        // Worker thread main loop
-        void workerThreadLoop();
+        // Send a finished task's response and broadcasts (network thread)
+        void deliverTaskResult(const Task &task);
 
         // Helper methods
-        void processPacket(int clientFd, uint16_t packetType, const uint8_t *data, size_t len);
-        void sendResponse(int clientFd, const std::vector<uint8_t> &packet);
+        void processPacket(int clientFd, const PacketView &packet);
+        void dispatchTask(const TaskPtr &task, const PacketView &request);
+        bool allowAuthRequest(int clientFd, const std::string *username);
+        void sendResponse(int clientFd, const std::vector<uint8_t> &packet, uint8_t version, uint32_t requestId);
+        void broadcast(const Broadcast &notification);
+        // version 0 = the connection's version (pushes); responses use their request's
+        void sendPacket(int clientFd, const std::vector<uint8_t> &packet, const SharedPacket *shared,
+                        uint8_t version = 0, uint32_t requestId = 0);
+        void updateInterest(Connection &conn);
+        void closeConnection(int clientFd);
+        void detachSession(int clientFd, const std::string &username, const std::string &token);
+        void replayOutbox(int detachedFd, int clientFd);
+        void expireDetachedSessions();
+        std::string buildStatusReport() const;
+
+        // O(1) fd -> connection (nullptr if none)
+        Connection *getConnection(int clientFd) const
+        {
+            return (clientFd >= 0 && (size_t)clientFd < connections.size()) ? connections[clientFd].get() : nullptr;
+        }
+
+        // Connection that sent the task; nullptr once it closed, even if a
+        // new client got the same fd
+        Connection *getTaskConnection(const Task &task) const;
 
         int port;
+        ServerConfig config;
         int listenFd;
+        int reserveFd; // Spare fd released to shed connections when out of fds
+        int adminFd;   // Admin listening socket (-1 if disabled)
+        uint64_t startedAt; // Metrics::nowNs() at construction
         std::atomic<bool> running;
         bool initialized = false;
 
         // Event loop for network I/O
         std::unique_ptr<EventLoop> eventLoop;
 
-        // Connection management
-        std::map<int, ConnectionPtr> connections;
+        // Connection management: dense table indexed by fd
+        std::vector<ConnectionPtr> connections;
+        size_t connectionCount = 0;
+
+        // Scratch payload buffer for packet decoding (network thread only)
+        ByteBuffer packetBuf;
+
+        // Login/register floods are shed here (network thread only)
+        RateLimiter<uint32_t> authAddressLimiter;
+        RateLimiter<std::string> loginUserLimiter;
+
+        // Sessions whose connection dropped, keyed by detached id (see
+        // AuthService::detachedFd). Network thread only.
+        struct DetachedSession
+        {
+            std::string username;
+            std::string token;
+            uint64_t detachedAt;
+            std::deque<SharedPacket> outbox; // Oldest first, at most resumeOutboxLimit
+        };
+        std::unordered_map<int, DetachedSession> detachedSessions;
 
         // Task and callback queues
         std::unique_ptr<TaskQueue> taskQueue;
         std::unique_ptr<CallbackQueue> callbackQueue;
 
-        // Worker thread
-        std::thread workerThread;
+        // Worker pool
+        std::vector<std::thread> workerThreads;
+
+        // Auth pool: own queue and threads for password hashing
+        std::unique_ptr<TaskQueue> authQueue;
+        std::vector<std::thread> authThreads;
     };
 
 } // namespace hangman
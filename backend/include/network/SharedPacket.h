@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace hangman {
+
+// Encoded packet shared by every connection it is sent to. Immutable once
+// built: connections queue it by reference instead of copying the bytes.
+using SharedPacket = std::shared_ptr<const std::vector<uint8_t>>;
+
+inline SharedPacket makeSharedPacket(std::vector<uint8_t> bytes) {
+    return std::make_shared<const std::vector<uint8_t>>(std::move(bytes));
+}
+
+// One notification fanned out to many clients: encoded once, sent to each target fd
+struct Broadcast {
+    SharedPacket packet;
+    std::vector<int> targets;
+};
+
+} // namespace hangman
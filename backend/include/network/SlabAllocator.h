@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <memory>
+
+namespace hangman {
+
+// Fixed-size object slab: carves objects out of chunks of OBJECTS_PER_SLAB
+// slots and recycles freed slots through an intrusive free list.
+// Not thread-safe; meant for objects owned by a single thread.
+template <size_t ObjectSize, size_t ObjectsPerSlab = 64>
+class SlabAllocator {
+public:
+    void* allocate() {
+        if (!freeList) {
+            grow();
+        }
+        Slot* slot = freeList;
+        freeList = slot->next;
+        ++liveObjects;
+        return slot;
+    }
+
+    void deallocate(void* p) {
+        if (!p) {
+            return;
+        }
+        Slot* slot = static_cast<Slot*>(p);
+        slot->next = freeList;
+        freeList = slot;
+        --liveObjects;
+    }
+
+    size_t live() const { return liveObjects; }
+    size_t capacity() const { return slabs.size() * ObjectsPerSlab; }
+
+private:
+    union Slot {
+        Slot* next;
+        alignas(std::max_align_t) unsigned char storage[ObjectSize];
+    };
+
+    void grow() {
+        slabs.emplace_back(new Slot[ObjectsPerSlab]);
+        Slot* slab = slabs.back().get();
+        for (size_t i = 0; i < ObjectsPerSlab; ++i) {
+            slab[i].next = freeList;
+            freeList = &slab[i];
+        }
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> slabs;
+    Slot* freeList = nullptr;
+    size_t liveObjects = 0;
+};
+
+} // namespace hangman
@@ -1,12 +1,23 @@
 // include/network/Socket.h
 #pragma once
 #include <string>
+#include <netinet/in.h>
 
 class Socket {
 public:
-    static int createListeningSocket(int port);
+    // Listening socket is created non-blocking and close-on-exec.
+    // loopbackOnly binds 127.0.0.1 instead of all interfaces.
+    static int createListeningSocket(int port, bool loopbackOnly = false);
     static void setNonBlocking(int fd);
     static void setReuseAddr(int fd);
-    static int acceptConnection(int listenFd);
+
+    // Per-socket tuning (best effort, failures are ignored)
+    static void setNoDelay(int fd);
+    static void setBufferSizes(int fd, int sendBytes, int recvBytes);  // 0 = keep default
+    static void setDeferAccept(int listenFd, int seconds);
+
+    // accept4() with SOCK_NONBLOCK | SOCK_CLOEXEC: no extra fcntl calls.
+    // Returns -1 when nothing is pending (errno is preserved).
+    static int acceptConnection(int listenFd, sockaddr_in* peerAddr = nullptr);
     static void closeSocket(int fd);
 };
\ No newline at end of file
@@ -9,6 +9,12 @@ namespace hangman {
 // Protocol version
 constexpr uint8_t PROTOCOL_VERSION = 1;
 
+// v2 header adds a u32 request id after the length. The server echoes it in
+// the response, so replies can be matched out of order; pushes carry 0.
+// Payloads are the same in both versions, and each reply uses the version
+// of its request (v1 clients keep working unchanged).
+constexpr uint8_t PROTOCOL_VERSION_V2 = 2;
+
 // Maxs
 constexpr size_t MAX_USERNAME_LEN = 64;
 constexpr size_t MAX_PASSWORD_LEN = 64;
@@ -25,6 +31,8 @@ enum class PacketType : uint16_t {
     S2C_LoginResult        = 0x0104,
     C2S_Logout             = 0x0105,
     S2C_LogoutAck          = 0x0106,
+    C2S_ResumeSession      = 0x0107,
+    S2C_ResumeResult       = 0x0108,
 
     // Lobby / Room
     C2S_CreateRoom         = 0x0201,
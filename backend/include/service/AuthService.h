@@ -5,6 +5,9 @@
 #include <unordered_map>
 #include <mutex>
 #include <memory>
+#include <atomic>
+#include <vector>
+#include <functional>
 
 namespace hangman {
 
@@ -48,9 +51,17 @@ public:
 
     // Validate session token
     bool validateSession(const std::string& token, std::string& outUsername);
+
+    // Resolve the requester: an empty token means the session bound to the
+    // connection (boundUser, set by the network thread after login) and skips
+    // the session table; any other token is validated as usual
+    bool authenticate(const std::string& token, const std::string& boundUser, std::string& outUsername);
     
     // Get all active sessions (for online list)
     std::vector<Session> getAllSessions();
+
+    // Usernames of all active sessions (cheaper than getAllSessions)
+    std::vector<std::string> getOnlineUsernames();
     
     // Get clientFd by username
     int getClientFd(const std::string& username);
@@ -58,29 +69,95 @@ public:
         // Get session info
     bool getSessionInfo(const std::string& token, Session& outSession);
 
+    // A session whose connection dropped is detached: its clientFd becomes a
+    // negative id (detachedFd of its slot) until the client resumes, so
+    // notifications for it can be held instead of sent to a reused fd.
+    static constexpr int DETACHED_FD_BASE = -2;
+    static int detachedFd(uint32_t slot) { return DETACHED_FD_BASE - (int)slot; }
+    static bool isDetachedFd(int clientFd) { return clientFd <= DETACHED_FD_BASE; }
+
+    // Detach the session if it is still bound to clientFd; returns its
+    // detached id, or -1 if the token is dead or the session moved on
+    int detachSession(const std::string& token, int clientFd);
+
+    // Rebind a live session to clientFd; previousFd is where it was bound
+    // (detached id, an older connection, or -1 after a restart)
+    bool resumeSession(const std::string& token, int clientFd, Session& outSession, int& previousFd);
+
+    // Tokens of all detached sessions (restored from a snapshot, for example)
+    std::vector<std::string> getDetachedTokens();
+
+    // Log out a session nobody resumed in time (only if still detached as detachedFd)
+    bool expireSession(const std::string& token, int detachedFd);
+
     // Update user stats
     void updateUserStats(const std::string& username, bool isWin, uint32_t points);
+
+    // Account changes not on disk yet (password hashes upgraded at login) are
+    // written in one batch by flushUsers() or with the next stats update,
+    // never on the login path itself
+    bool hasUnsavedUsers() const { return usersDirty.load(std::memory_order_relaxed); }
+    bool flushUsers();
     
     // Get all users (for leaderboard)
     std::vector<User> getAllUsers();
 
+    // Live sessions for StateSnapshot. Restored sessions keep their tokens and
+    // come back detached until the client resumes.
+    // parseState only reads its section; the returned function installs it
+    // (StateSnapshot calls it once every section parsed)
+    void saveState(ByteBuffer& out);
+    std::function<void()> parseState(ByteBuffer& in);
+
+    // PBKDF2 iteration count for new and upgraded password hashes
+    void setHashIterations(uint32_t iterations) { hashIterations.store(iterations, std::memory_order_relaxed); }
+    uint32_t getHashIterations() const { return hashIterations.load(std::memory_order_relaxed); }
+
+    // Bumped whenever a user is added or user stats change (leaderboard cache key)
+    uint64_t getStatsVersion() const { return statsVersion.load(std::memory_order_acquire); }
+
 private:
     AuthService();
     ~AuthService() = default;
 
     bool userExists(const std::string& username);
-    bool verifyPassword(const std::string& username, const std::string& password);
-    void addUser(const std::string& username, const std::string& password);
+    bool verifyPassword(const std::string& password, const std::string& storedHash, bool& needsUpgrade);
     std::string hashPassword(const std::string& password);
-    std::string generateSessionToken(const std::string& username);
-    bool saveUserToDatabase(const std::string& username, const std::string& password);
-    bool saveAllUsersToDatabase(); // Rewrite entire file
+    // Hash at the current cost that no password is checked against for real:
+    // unknown usernames are verified against it so they take as long as known ones
+    const std::string& dummyHash();
+    uint32_t allocateSessionSlot();
+    bool saveUserToDatabase(const std::string& username, const std::string& passwordHash);
+    std::string serializeUsers();                     // Call with usersMutex held
+    bool writeUsersFile(const std::string& contents); // Rewrite entire file (temp + rename)
 
     std::string dbPath;
     std::unordered_map<std::string, User> users;
     std::mutex usersMutex;
-
-    std::unordered_map<std::string, Session> sessions;
+    std::mutex usersFileMutex;                 // Serializes file writes; taken before usersMutex
+    std::atomic<bool> usersDirty{false};
+    std::atomic<uint64_t> statsVersion{0};
+    std::atomic<uint32_t> hashIterations;
+
+    // Session token = 16 bytes: slot index (4) + slot generation (4) + random secret (8).
+    // Lookup is an index into sessionSlots; logout bumps the generation so old tokens die.
+    static constexpr size_t SESSION_TOKEN_SIZE = 16;
+
+    struct SessionSlot {
+        uint32_t generation = 0;
+        bool active = false;
+        uint64_t secret = 0;
+        Session session;
+    };
+
+    // Note: Call with sessionsMutex already locked; nullptr if the token is not live
+    SessionSlot* findSession(const std::string& token);
+    void removeSession(SessionSlot* slot);
+
+    std::vector<SessionSlot> sessionSlots;
+    std::vector<uint32_t> freeSlots;
+    std::unordered_map<std::string, uint32_t> userSlots; // username -> newest session slot
+    size_t activeSessions = 0;
     std::mutex sessionsMutex;
 };
 
@@ -51,21 +51,21 @@ public:
     BeforePlayService& operator=(const BeforePlayService&) = delete;
 
     // Get Online List (Free players)
-    S2C_OnlineList getOnlineList(const C2S_RequestOnlineList& request);
+    S2C_OnlineList getOnlineList(const C2S_RequestOnlineList& request, const std::string& boundUser = std::string());
 
     // Invite Player
-    InviteResult sendInvite(const C2S_SendInvite& request, int senderFd);
-    RespondInviteResult respondInvite(const C2S_RespondInvite& request, int targetFd);
+    InviteResult sendInvite(const C2S_SendInvite& request, int senderFd, const std::string& boundUser = std::string());
+    RespondInviteResult respondInvite(const C2S_RespondInvite& request, int targetFd, const std::string& boundUser = std::string());
 
     // Set Ready
     // Unset Ready (Handled by setReady with ready=false)
-    SetReadyResult setReady(const C2S_SetReady& request, int clientFd);
+    SetReadyResult setReady(const C2S_SetReady& request, int clientFd, const std::string& boundUser = std::string());
     
     // Kick Player
-    KickResult kickPlayer(const C2S_KickPlayer& request, int hostFd);
+    KickResult kickPlayer(const C2S_KickPlayer& request, int hostFd, const std::string& boundUser = std::string());
     
     // Start Game (Host triggers)
-    StartGameResult startGame(const C2S_StartGame& request, int hostFd);
+    StartGameResult startGame(const C2S_StartGame& request, int hostFd, const std::string& boundUser = std::string());
 
 private:
     BeforePlayService() = default;
@@ -6,6 +6,8 @@
 #include <unordered_map>
 #include <set>
 #include <mutex>
+#include <memory>
+#include <functional>
 
 namespace hangman {
 
@@ -56,21 +58,38 @@ public:
     void startMatch(uint32_t roomId, const std::vector<std::string>& players, const std::string& word);
 
     // Game Actions
-    GuessCharResult guessChar(const C2S_GuessChar& request);
-    GuessWordResult guessWord(const C2S_GuessWord& request);
+    GuessCharResult guessChar(const C2S_GuessChar& request, const std::string& boundUser = std::string());
+    GuessWordResult guessWord(const C2S_GuessWord& request, const std::string& boundUser = std::string());
     
     // Draw Request
     // Returns pair<targetFd, packet>
-    std::pair<int, S2C_DrawRequest> requestDraw(const C2S_RequestDraw& request);
+    std::pair<int, S2C_DrawRequest> requestDraw(const C2S_RequestDraw& request, const std::string& boundUser = std::string());
 
     // End Game (Resign or explicit end)
-    EndGameResult endGame(const C2S_EndGame& request);
+    EndGameResult endGame(const C2S_EndGame& request, const std::string& boundUser = std::string());
+
+    // Copy of all active matches (for the admin dump)
+    std::vector<Match> getActiveMatches();
+
+    // Matches for StateSnapshot (each one copied under its own lock)
+    void saveState(ByteBuffer& out);
+    std::function<void()> parseState(ByteBuffer& in);
 
 private:
     MatchService() = default;
     ~MatchService() = default;
 
-    std::unordered_map<uint32_t, Match> matches; // Map roomId -> Match (Assuming 1 match per room)
+    // Each match has its own lock; matchesMutex only guards the map itself,
+    // so matches in different rooms never wait on each other
+    struct MatchEntry {
+        std::mutex mutex;
+        Match match;
+    };
+    using MatchEntryPtr = std::shared_ptr<MatchEntry>;
+
+    MatchEntryPtr findMatch(uint32_t roomId);
+
+    std::unordered_map<uint32_t, MatchEntryPtr> matches; // Map roomId -> Match (Assuming 1 match per room)
     std::mutex matchesMutex;
 
     std::string getExposedPattern(const std::string& word, const std::set<char>& guessed);
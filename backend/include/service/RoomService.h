@@ -5,6 +5,7 @@
 #include <unordered_map>
 #include <mutex>
 #include <vector>
+#include <functional>
 #include <atomic>
 
 namespace hangman {
@@ -60,13 +61,15 @@ public:
     RoomService& operator=(const RoomService&) = delete;
 
     // Service methods
-    S2C_CreateRoomResult createRoom(const C2S_CreateRoom& request, int clientFd);
-    LeaveRoomResult leaveRoom(const C2S_LeaveRoom& request, int clientFd);
+    S2C_CreateRoomResult createRoom(const C2S_CreateRoom& request, int clientFd, const std::string& boundUser = std::string());
+    LeaveRoomResult leaveRoom(const C2S_LeaveRoom& request, int clientFd, const std::string& boundUser = std::string());
 
     // Helper methods for BeforePlayService
     bool isUserInRoom(const std::string& username);
-    Room* getRoom(uint32_t roomId);
-    Room* getRoomByUsername(const std::string& username);
+    // Copies taken under roomsMutex (rooms change on other actors and on
+    // rebindClient); false if there is no such room
+    bool getRoom(uint32_t roomId, Room& out);
+    bool getRoomByUsername(const std::string& username, Room& out);
     
     // Allow BeforePlayService to access private members if needed, or expose necessary methods
     // For now, we'll expose methods.
@@ -81,14 +84,31 @@ public:
     // Kick player
     void kickPlayer(uint32_t roomId, const std::string& username);
 
+    // Move a player's notifications from fromFd to toFd (detach/resume).
+    // Entries without a live connection (clientFd < 0) are rebound too;
+    // a newer live connection of the same user is left alone.
+    void rebindClient(const std::string& username, int fromFd, int toFd);
+
     // Getters
     std::vector<PlayerInfo> getRoomPlayers(uint32_t roomId);
 
+    // Copy of all rooms (for the admin dump)
+    std::vector<Room> getAllRooms();
+
+    // Rooms for StateSnapshot; restored players have no connection (clientFd -1)
+    void saveState(ByteBuffer& out);
+    std::function<void()> parseState(ByteBuffer& in);
+
 private:
     RoomService();
     ~RoomService() = default;
 
+    // Call with roomsMutex held
+    void addMembership(const std::string& username, uint32_t roomId);
+    void removeMembership(const std::string& username, uint32_t roomId);
+
     std::unordered_map<uint32_t, Room> rooms;
+    std::unordered_map<std::string, std::vector<uint32_t>> roomMembership; // username -> ids of rooms joined (O(1) isUserInRoom)
     std::mutex roomsMutex;
     std::atomic<uint32_t> nextRoomId{1};  // Đảm bảo các thao tác đọc ghi với biến này là nguyên tử
 };
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace hangman {
+
+// Binary snapshot of the in-memory server state (sessions, rooms, matches)
+// so a restart does not log everyone out. Accounts stay in the database file.
+//
+// Layout: u32 magic, u32 format version, then each service's section in
+// ByteBuffer encoding. Written to <path>.tmp, fsync'ed and renamed over
+// <path>, so a crash mid-write never leaves a truncated snapshot.
+// Each service is copied under its own lock: the snapshot is consistent per
+// service, not across services.
+class StateSnapshot {
+public:
+    static constexpr uint32_t MAGIC = 0x484D5353; // "HMSS"
+    static constexpr uint32_t FORMAT_VERSION = 1;
+
+    // Serialize and write; returns false (and logs) on I/O errors
+    static bool save(const std::string& path);
+
+    // Restore from path. Missing file = nothing to restore (true);
+    // unreadable or corrupt file is logged and ignored (false).
+    static bool load(const std::string& path);
+};
+
+} // namespace hangman
@@ -2,6 +2,7 @@
 
 #include "protocol/packets.h"
 #include <vector>
+#include <mutex>
 
 namespace hangman {
 
@@ -12,12 +13,24 @@ public:
     SummaryService(const SummaryService&) = delete;
     SummaryService& operator=(const SummaryService&) = delete;
 
-    S2C_HistoryList getHistory(const C2S_RequestHistory& request);
-    S2C_Leaderboard getLeaderboard(const C2S_RequestLeaderboard& request);
+    S2C_HistoryList getHistory(const C2S_RequestHistory& request, const std::string& boundUser = std::string());
+    S2C_Leaderboard getLeaderboard(const C2S_RequestLeaderboard& request, const std::string& boundUser = std::string());
+
+    // True if the cached top 10 matches the current user stats, i.e. the
+    // next getLeaderboard is a session check plus a copy
+    bool isLeaderboardCached() const;
 
 private:
     SummaryService() = default;
     ~SummaryService() = default;
+
+    static constexpr size_t LEADERBOARD_SIZE = 10;
+
+    // Top rows, valid while cachedVersion == AuthService::getStatsVersion()
+    mutable std::mutex leaderboardMutex;
+    std::vector<S2C_Leaderboard::Row> cachedRows;
+    uint64_t cachedVersion = 0;
+    bool cacheValid = false;
 };
 
 } // namespace hangman
@@ -25,10 +25,16 @@ class Callback {
 public:
     virtual ~Callback() = default;
     virtual void execute() = 0;
+
+    // Push time (Metrics::nowNs), for the callback delay metric
+    uint64_t enqueuedAt = 0;
 };
 
 using CallbackPtr = std::shared_ptr<Callback>;
 
+class Task;
+using TaskPtr = std::shared_ptr<Task>;
+
 // Simple callback wrapper for std::function
 class FunctionCallback : public Callback {
 public:
@@ -43,12 +49,29 @@ private:
     std::function<void()> func;
 };
 
+// Results of all tasks the worker ran in one wakeup: one queue push and one
+// eventfd write for the whole batch. Delivers each task in order and records
+// its callback delay.
+class TaskBatchCallback : public Callback {
+public:
+    using DeliverFn = std::function<void(const Task&)>;
+
+    TaskBatchCallback(std::vector<TaskPtr> tasks, DeliverFn deliver)
+        : tasks(std::move(tasks)), deliver(std::move(deliver)) {}
+    void execute() override;
+
+private:
+    std::vector<TaskPtr> tasks;
+    DeliverFn deliver;
+};
+
 class CallbackQueue {
 public:
     CallbackQueue();
     ~CallbackQueue();
 
-    // Push callback from worker thread
+    // Push callback from worker thread. Only the push that makes the queue
+    // non-empty writes the eventfd; later ones are drained by the same popAll.
     void push(CallbackPtr callback);
 
     // Pop all pending callbacks (network thread only)
@@ -60,6 +83,9 @@ public:
     // Reset the notification after processing
     void resetNotification();
 
+    // Get queue size
+    size_t size() const;
+
 private:
     mutable std::mutex mutex;
     std::queue<CallbackPtr> queue;
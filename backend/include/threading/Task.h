@@ -2,6 +2,7 @@
 
 #include "protocol/packets.h"
 #include "threading/TaskQueue.h"
+#include "network/SharedPacket.h"
 #include "service/RoomService.h" // Include here for LeaveRoomResult
 #include <memory>
 #include <cstdint>
@@ -10,6 +11,17 @@
 
 namespace hangman {
 
+// Change to a connection's bound session, applied on the network thread when
+// the task is delivered. Login binds (username set), logout releases (username
+// empty; only if the connection is still bound to token). Resume also names
+// where the session was bound before, so its outbox can be replayed.
+struct SessionBinding {
+    int clientFd = -1;
+    std::string username;
+    std::string token;
+    int previousFd = -1;
+};
+
 // Abstract Task interface
 class Task {
 public:
@@ -21,13 +33,61 @@ public:
     // Get client fd (để biết người gửi là ai, phục vụ broadcast)
     virtual int getClientFd() const = 0;
 
+    // Request packet type (metrics key)
+    virtual uint16_t getPacketType() const = 0;
+
     // Get serialized response packet
     virtual std::vector<uint8_t> getResponsePacket() const = 0;
 
-    // Get broadcast packets (clientFd, packetData)
-    virtual std::vector<std::pair<int, std::vector<uint8_t>>> getBroadcastPackets() const {
-        return {};
+    // Actor this task belongs to (see TaskQueue): tasks of one actor run in
+    // order, never concurrently. Lobby-wide state (rooms, invites) stays on
+    // one actor; each match is its own actor; password work is per client.
+    virtual uint64_t getActorKey() const { return LOBBY_ACTOR; }
+
+    static constexpr uint64_t LOBBY_ACTOR = 0;
+    static uint64_t roomActor(uint32_t roomId) { return (1ull << 32) | roomId; }
+    static uint64_t clientActor(int clientFd) { return (2ull << 32) | (uint32_t)clientFd; }
+
+    // CPU-heavy password hashing (login/register) runs on the separate,
+    // bounded auth pool so a login storm cannot starve game traffic
+    virtual bool usesAuthPool() const { return false; }
+
+    // Fill in a "server busy" response when the auth pool is full
+    virtual void rejectBusy() {}
+
+    // Cheap, read-only tasks (no file I/O, short locks) run inline on the
+    // network thread instead of going through the worker
+    virtual bool isNonBlocking() const { return false; }
+
+    // Notifications to other clients, each encoded once for all its targets
+    virtual const std::vector<Broadcast>& getBroadcasts() const {
+        static const std::vector<Broadcast> none;
+        return none;
     }
+
+    // Session binding to apply on delivery (login/logout only)
+    virtual const SessionBinding* getSessionBinding() const { return nullptr; }
+
+    // Stamped by TaskQueue::push (Metrics::nowNs), used for queue-wait metrics
+    uint64_t enqueuedAt = 0;
+
+    // Header of the request (set at dispatch): the response is framed in the
+    // same protocol version and echoes the v2 request id
+    uint8_t requestVersion = PROTOCOL_VERSION;
+    uint32_t requestId = 0;
+
+    // Connection::id() of the requester (set at dispatch). Its fd may be
+    // closed and reused by another client before the task is delivered.
+    uint64_t connectionId = 0;
+
+    // Set when execute() threw: the requester gets an S2C_Error for the
+    // request instead of the response, and nothing else is applied
+    bool failed = false;
+
+    // Session bound to the requesting connection at dispatch (empty if none).
+    // Requests sent with an empty token run as this user.
+    std::string boundUser;
+    std::string boundToken;
 };
 
 using TaskPtr = std::shared_ptr<Task>;
@@ -40,7 +100,11 @@ public:
 
     void execute() override;
     int getClientFd() const override { return clientFd; }
+    uint16_t getPacketType() const override { return (uint16_t)PacketType::C2S_Register; }
     std::vector<uint8_t> getResponsePacket() const override;
+    uint64_t getActorKey() const override { return clientActor(clientFd); }
+    bool usesAuthPool() const override { return true; }
+    void rejectBusy() override;
 
     const S2C_RegisterResult& getResult() const { return result; }
 
@@ -58,14 +122,20 @@ public:
 
     void execute() override;
     int getClientFd() const override { return clientFd; }
+    uint16_t getPacketType() const override { return (uint16_t)PacketType::C2S_Login; }
     std::vector<uint8_t> getResponsePacket() const override;
+    uint64_t getActorKey() const override { return clientActor(clientFd); }
+    bool usesAuthPool() const override { return true; }
+    void rejectBusy() override;
 
     const S2C_LoginResult& getResult() const { return result; }
+    const SessionBinding* getSessionBinding() const override;
 
 private:
     int clientFd;
     C2S_Login request;
     S2C_LoginResult result;
+    SessionBinding binding;
 };
 
 // ============ Logout Task ============
@@ -76,14 +146,38 @@ public:
 
     void execute() override;
     int getClientFd() const override { return clientFd; }
+    uint16_t getPacketType() const override { return (uint16_t)PacketType::C2S_Logout; }
     std::vector<uint8_t> getResponsePacket() const override;
 
     const S2C_LogoutAck& getResult() const { return result; }
+    const SessionBinding* getSessionBinding() const override;
 
 private:
     int clientFd;
     C2S_Logout request;
     S2C_LogoutAck result;
+    SessionBinding binding; // Connection that owned the session
+};
+
+// ============ Resume Session Task ============
+class ResumeSessionTask : public Task {
+public:
+    ResumeSessionTask(int clientFd, const C2S_ResumeSession& request)
+        : clientFd(clientFd), request(request) {}
+
+    void execute() override;
+    int getClientFd() const override { return clientFd; }
+    uint16_t getPacketType() const override { return (uint16_t)PacketType::C2S_ResumeSession; }
+    std::vector<uint8_t> getResponsePacket() const override;
+    bool isNonBlocking() const override { return true; }
+
+    const SessionBinding* getSessionBinding() const override;
+
+private:
+    int clientFd;
+    C2S_ResumeSession request;
+    S2C_ResumeResult result;
+    SessionBinding binding;
 };
 
 // ============ Create Room Task ============
@@ -94,6 +188,7 @@ public:
 
     void execute() override;
     int getClientFd() const override { return clientFd; }
+    uint16_t getPacketType() const override { return (uint16_t)PacketType::C2S_CreateRoom; }
     std::vector<uint8_t> getResponsePacket() const override;
 
 private:
@@ -110,13 +205,15 @@ public:
 
     void execute() override;
     int getClientFd() const override { return clientFd; }
+    uint16_t getPacketType() const override { return (uint16_t)PacketType::C2S_LeaveRoom; }
     std::vector<uint8_t> getResponsePacket() const override;
-    std::vector<std::pair<int, std::vector<uint8_t>>> getBroadcastPackets() const override;
+    const std::vector<Broadcast>& getBroadcasts() const override { return broadcasts; }
 
 private:
     int clientFd;
     C2S_LeaveRoom request;
     LeaveRoomResult fullResult;
+    std::vector<Broadcast> broadcasts;
 };
 
 // ============ Request Online List Task ============
@@ -127,7 +224,9 @@ public:
 
     void execute() override;
     int getClientFd() const override { return clientFd; }
+    uint16_t getPacketType() const override { return (uint16_t)PacketType::C2S_RequestOnlineList; }
     std::vector<uint8_t> getResponsePacket() const override;
+    bool isNonBlocking() const override { return true; }
 
 private:
     int clientFd;
@@ -143,14 +242,15 @@ public:
 
     void execute() override;
     int getClientFd() const override { return clientFd; }
+    uint16_t getPacketType() const override { return (uint16_t)PacketType::C2S_SendInvite; }
     std::vector<uint8_t> getResponsePacket() const override;
-    std::vector<std::pair<int, std::vector<uint8_t>>> getBroadcastPackets() const override;
+    const std::vector<Broadcast>& getBroadcasts() const override { return broadcasts; }
 
 private:
     int clientFd;
     C2S_SendInvite request;
     S2C_Ack result; // Ack to sender
-    std::vector<std::pair<int, std::vector<uint8_t>>> broadcastPackets; // Invite to target
+    std::vector<Broadcast> broadcasts; // Invite to target
 };
 
 // ============ Respond Invite Task ============
@@ -161,15 +261,16 @@ public:
 
     void execute() override;
     int getClientFd() const override { return clientFd; }
+    uint16_t getPacketType() const override { return (uint16_t)PacketType::C2S_RespondInvite; }
     std::vector<uint8_t> getResponsePacket() const override;
-    std::vector<std::pair<int, std::vector<uint8_t>>> getBroadcastPackets() const override;
+    const std::vector<Broadcast>& getBroadcasts() const override { return broadcasts; }
 
 private:
     int clientFd;
     C2S_RespondInvite request;
     S2C_CreateRoomResult joinResult; // If accepted, result of joining room
     bool accepted;
-    std::vector<std::pair<int, std::vector<uint8_t>>> broadcastPackets; // Response to inviter
+    std::vector<Broadcast> broadcasts; // Response to inviter
 };
 
 // ============ Set Ready Task ============
@@ -180,14 +281,15 @@ public:
 
     void execute() override;
     int getClientFd() const override { return clientFd; }
+    uint16_t getPacketType() const override { return (uint16_t)PacketType::C2S_SetReady; }
     std::vector<uint8_t> getResponsePacket() const override;
-    std::vector<std::pair<int, std::vector<uint8_t>>> getBroadcastPackets() const override;
+    const std::vector<Broadcast>& getBroadcasts() const override { return broadcasts; }
 
 private:
     int clientFd;
     C2S_SetReady request;
     S2C_Ack result;
-    std::vector<std::pair<int, std::vector<uint8_t>>> broadcastPackets;
+    std::vector<Broadcast> broadcasts;
 };
 
 // ============ Start Game Task ============
@@ -198,14 +300,15 @@ public:
 
     void execute() override;
     int getClientFd() const override { return clientFd; }
+    uint16_t getPacketType() const override { return (uint16_t)PacketType::C2S_StartGame; }
     std::vector<uint8_t> getResponsePacket() const override;
-    std::vector<std::pair<int, std::vector<uint8_t>>> getBroadcastPackets() const override;
+    const std::vector<Broadcast>& getBroadcasts() const override { return broadcasts; }
 
 private:
     int clientFd;
     C2S_StartGame request;
     S2C_Ack result; // Ack to host (or error)
-    std::vector<std::pair<int, std::vector<uint8_t>>> broadcastPackets; // GameStart to both
+    std::vector<Broadcast> broadcasts; // GameStart to both
 };
 
 // ============ Kick Player Task ============
@@ -216,14 +319,15 @@ public:
 
     void execute() override;
     int getClientFd() const override { return clientFd; }
+    uint16_t getPacketType() const override { return (uint16_t)PacketType::C2S_KickPlayer; }
     std::vector<uint8_t> getResponsePacket() const override;
-    std::vector<std::pair<int, std::vector<uint8_t>>> getBroadcastPackets() const override;
+    const std::vector<Broadcast>& getBroadcasts() const override { return broadcasts; }
 
 private:
     int clientFd;
     C2S_KickPlayer request;
     S2C_KickResult result;
-    std::vector<std::pair<int, std::vector<uint8_t>>> broadcastPackets; // Notification to kicked player
+    std::vector<Broadcast> broadcasts; // Notification to kicked player
 };
 
 // ============ Guess Char Task ============
@@ -234,6 +338,8 @@ public:
 
     void execute() override;
     int getClientFd() const override { return clientFd; }
+    uint16_t getPacketType() const override { return (uint16_t)PacketType::C2S_GuessChar; }
+    uint64_t getActorKey() const override { return roomActor(request.room_id); }
     std::vector<uint8_t> getResponsePacket() const override;
 
 private:
@@ -252,6 +358,8 @@ public:
 
     void execute() override;
     int getClientFd() const override { return clientFd; }
+    uint16_t getPacketType() const override { return (uint16_t)PacketType::C2S_GuessWord; }
+    uint64_t getActorKey() const override { return roomActor(request.room_id); }
     std::vector<uint8_t> getResponsePacket() const override;
 
 private:
@@ -270,13 +378,15 @@ public:
 
     void execute() override;
     int getClientFd() const override { return clientFd; }
+    uint16_t getPacketType() const override { return (uint16_t)PacketType::C2S_RequestDraw; }
+    uint64_t getActorKey() const override { return roomActor(request.room_id); }
     std::vector<uint8_t> getResponsePacket() const override;
-    std::vector<std::pair<int, std::vector<uint8_t>>> getBroadcastPackets() const override;
+    const std::vector<Broadcast>& getBroadcasts() const override { return broadcasts; }
 
 private:
     int clientFd;
     C2S_RequestDraw request;
-    std::vector<std::pair<int, std::vector<uint8_t>>> broadcastPackets;
+    std::vector<Broadcast> broadcasts;
 };
 
 // ============ End Game Task ============
@@ -287,8 +397,10 @@ public:
 
     void execute() override;
     int getClientFd() const override { return clientFd; }
+    uint16_t getPacketType() const override { return (uint16_t)PacketType::C2S_EndGame; }
+    uint64_t getActorKey() const override { return roomActor(request.room_id); }
     std::vector<uint8_t> getResponsePacket() const override;
-    std::vector<std::pair<int, std::vector<uint8_t>>> getBroadcastPackets() const override;
+    const std::vector<Broadcast>& getBroadcasts() const override { return broadcasts; }
 
 private:
     int clientFd;
@@ -296,7 +408,7 @@ private:
     S2C_GameEnd result;
     S2C_Error error;
     bool success;
-    std::vector<std::pair<int, std::vector<uint8_t>>> broadcastPackets;
+    std::vector<Broadcast> broadcasts;
 };
 
 // ============ Request History Task ============
@@ -307,6 +419,7 @@ public:
 
     void execute() override;
     int getClientFd() const override { return clientFd; }
+    uint16_t getPacketType() const override { return (uint16_t)PacketType::C2S_RequestHistory; }
     std::vector<uint8_t> getResponsePacket() const override;
 
 private:
@@ -323,7 +436,9 @@ public:
 
     void execute() override;
     int getClientFd() const override { return clientFd; }
+    uint16_t getPacketType() const override { return (uint16_t)PacketType::C2S_RequestLeaderboard; }
     std::vector<uint8_t> getResponsePacket() const override;
+    bool isNonBlocking() const override;  // Only while the leaderboard cache is fresh
 
 private:
     int clientFd;
@@ -331,4 +446,31 @@ private:
     S2C_Leaderboard result;
 };
 
+// ============ Snapshot Task ============
+// Periodic state snapshot (no client, no response). Runs on the lobby actor,
+// so it never lands in the middle of a room or invite change.
+class SnapshotTask : public Task {
+public:
+    explicit SnapshotTask(const std::string& path) : path(path) {}
+
+    void execute() override;
+    int getClientFd() const override { return -1; }
+    uint16_t getPacketType() const override { return 0; }
+    std::vector<uint8_t> getResponsePacket() const override { return {}; }
+
+private:
+    std::string path;
+};
+
+// ============ Flush Users Task ============
+// Writes pending account file changes (AuthService::flushUsers) off the
+// network thread
+class FlushUsersTask : public Task {
+public:
+    void execute() override;
+    int getClientFd() const override { return -1; }
+    uint16_t getPacketType() const override { return 0; }
+    std::vector<uint8_t> getResponsePacket() const override { return {}; }
+};
+
 } // namespace hangman
@@ -1,9 +1,12 @@
 #pragma once
 
-#include <queue>
+#include <cstdint>
+#include <deque>
 #include <mutex>
 #include <condition_variable>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace hangman {
 
@@ -11,16 +14,25 @@ namespace hangman {
 class Task;
 using TaskPtr = std::shared_ptr<Task>;
 
+// Actor-style task queue for a pool of workers.
+// Every task belongs to an actor key (Task::getActorKey). Tasks with the same
+// key run one batch at a time in push order; different keys run in parallel
+// on different workers. A key is handed to one worker until it calls done().
 class TaskQueue {
 public:
     TaskQueue() = default;
     ~TaskQueue() = default;
 
-    // Push a task to the queue (thread-safe)
+    // Push a task to its actor's mailbox (thread-safe)
     void push(TaskPtr task);
 
-    // Pop a task from the queue (blocks if empty, unless stopped)
-    TaskPtr pop();
+    // Take up to max tasks of the next ready actor (blocks if none, unless
+    // stopped). Appends to out and returns the number popped; 0 means stopped.
+    // The caller owns that actor until done(key).
+    size_t popBatch(std::vector<TaskPtr>& out, size_t max);
+
+    // Release an actor taken by popBatch; reschedules it if tasks are waiting
+    void done(uint64_t key);
 
     // Signal that no more tasks will be added
     void stop();
@@ -28,13 +40,23 @@ public:
     // Check if queue is empty
     bool empty() const;
 
-    // Get queue size
+    // Get queue size (tasks waiting, all actors)
     size_t size() const;
 
+    // Actors with a non-empty mailbox or a batch running
+    size_t actorCount() const;
+
 private:
+    struct Mailbox {
+        std::deque<TaskPtr> tasks;
+        bool scheduled = false;  // In readyKeys or owned by a worker
+    };
+
     mutable std::mutex mutex;
     std::condition_variable cv;
-    std::queue<TaskPtr> queue;
+    std::unordered_map<uint64_t, Mailbox> mailboxes;
+    std::deque<uint64_t> readyKeys;  // Actors with tasks and no owner, FIFO
+    size_t queued = 0;
     bool stopped = false;
 };
 
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// Compile-time log level: calls below it compile to nothing (arguments are
+// not evaluated). Override with -DHANGMAN_LOG_LEVEL=0 to get debug logs.
+// 0 = DEBUG, 1 = INFO, 2 = WARN, 3 = ERROR
+#ifndef HANGMAN_LOG_LEVEL
+#define HANGMAN_LOG_LEVEL 1
+#endif
+
+namespace hangman {
+
+enum class LogLevel : uint8_t {
+    DEBUG = 0,
+    INFO = 1,
+    WARN = 2,
+    ERROR = 3
+};
+
+// Asynchronous logger.
+// Producers format into a fixed slot of a bounded lock-free ring (no lock,
+// no syscall); a background thread drains the ring and writes in batches.
+// When the ring is full the message is dropped and counted, never blocking
+// the caller. DEBUG/INFO go to stdout, WARN/ERROR to stderr.
+class Logger {
+public:
+    static Logger& getInstance();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    // Start the flusher thread. Before start (and after stop) messages are
+    // written synchronously so nothing is lost during startup/shutdown.
+    void start();
+
+    // Drain remaining messages and join the flusher thread
+    void stop();
+
+    // Runtime filter on top of the compile-time level
+    void setLevel(LogLevel level) { minLevel.store((uint8_t)level, std::memory_order_relaxed); }
+    bool enabled(LogLevel level) const { return (uint8_t)level >= minLevel.load(std::memory_order_relaxed); }
+
+    void log(LogLevel level, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
+
+    uint64_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+    static constexpr size_t SLOT_COUNT = 4096;   // Power of two
+    static constexpr size_t SLOT_SIZE = 256;     // Longer messages are truncated
+
+private:
+    Logger();
+    ~Logger();
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        uint64_t timestampMs;
+        LogLevel level;
+        uint16_t length;
+        char text[SLOT_SIZE - sizeof(std::atomic<size_t>) - sizeof(uint64_t) - 4];
+    };
+
+    static constexpr size_t MASK = SLOT_COUNT - 1;
+    static_assert((SLOT_COUNT & MASK) == 0, "Logger slot count must be a power of two");
+
+    bool tryPush(LogLevel level, uint64_t timestampMs, const char* text, size_t length);
+    size_t drain();
+    void flusherLoop();
+    static void writeLine(LogLevel level, uint64_t timestampMs, const char* text, size_t length);
+
+    Slot* slots;
+    alignas(64) std::atomic<size_t> enqueuePos{0};
+    alignas(64) size_t dequeuePos = 0;  // Flusher thread only
+    std::atomic<uint64_t> dropped{0};
+    uint64_t reportedDropped = 0;     // Flusher thread only
+    std::string outBatch, errBatch;   // Reused write batches, flusher thread only
+    std::atomic<uint8_t> minLevel{(uint8_t)HANGMAN_LOG_LEVEL};
+    std::atomic<bool> running{false};
+    std::thread flusher;
+};
+
+} // namespace hangman
+
+#define HANGMAN_LOG(level, ...)                                          \
+    do {                                                                 \
+        ::hangman::Logger& logger_ = ::hangman::Logger::getInstance();   \
+        if (logger_.enabled(level)) {                                    \
+            logger_.log(level, __VA_ARGS__);                             \
+        }                                                                \
+    } while (0)
+
+#if HANGMAN_LOG_LEVEL <= 0
+#define LOG_DEBUG(...) HANGMAN_LOG(::hangman::LogLevel::DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) do {} while (0)
+#endif
+
+#if HANGMAN_LOG_LEVEL <= 1
+#define LOG_INFO(...) HANGMAN_LOG(::hangman::LogLevel::INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) do {} while (0)
+#endif
+
+#if HANGMAN_LOG_LEVEL <= 2
+#define LOG_WARN(...) HANGMAN_LOG(::hangman::LogLevel::WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) do {} while (0)
+#endif
+
+#define LOG_ERROR(...) HANGMAN_LOG(::hangman::LogLevel::ERROR, __VA_ARGS__)
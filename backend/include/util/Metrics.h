@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace hangman {
+
+// Where a request spends its time, in pipeline order
+enum class MetricStage : uint8_t {
+    QUEUE_WAIT = 0,     // TaskQueue push -> worker pop
+    EXECUTE,            // Task::execute on the worker
+    CALLBACK_DELAY,     // CallbackQueue push -> callback run on the network thread
+    SEND,               // sendData + interest update for one outgoing packet
+    COUNT
+};
+
+enum class MetricCounter : uint8_t {
+    PACKETS_IN = 0,
+    BYTES_IN,
+    PACKETS_OUT,
+    BYTES_OUT,
+    CONNECTIONS_ACCEPTED,
+    CONNECTIONS_CLOSED,
+    SLOW_CLIENT_DROPS,
+    AUTH_REJECTED,       // Login/register refused because the auth pool was full
+    RATE_LIMITED,        // Login/register refused by a per-address/per-user limit
+    SESSIONS_RESUMED,    // Dropped connections picked up again with their token
+    OUTBOX_DROPPED,      // Notifications lost because a detached outbox was full
+    COUNT
+};
+
+// Log-linear latency histogram (HDR-style): each power of two is split into
+// 2^SUB_BITS linear buckets, so any recorded value is off by at most 12.5%.
+// Written by one thread, readable from any thread (relaxed atomics).
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BITS = 3;
+    static constexpr unsigned SUB_COUNT = 1u << SUB_BITS;
+    static constexpr unsigned MAX_BIT = 40;  // Values clamp at ~18 minutes (ns)
+    static constexpr size_t BUCKET_COUNT = (MAX_BIT - SUB_BITS + 2) * SUB_COUNT;
+
+    // Owning thread only
+    void record(uint64_t value);
+
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+
+    // Add this histogram's buckets into a plain array (for merging threads)
+    void mergeInto(uint64_t* buckets, uint64_t& count, uint64_t& sum, uint64_t& max) const;
+
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t bucketUpperBound(size_t index);
+
+private:
+    std::atomic<uint64_t> buckets[BUCKET_COUNT] = {};
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> maxValue{0};
+};
+
+// Process-wide metrics registry.
+// Every thread records into its own block (no sharing, no locks on the hot
+// path); snapshots merge all blocks. Histograms are allocated on first use
+// per (stage, packet type) so unused combinations cost one pointer.
+class Metrics {
+public:
+    static Metrics& getInstance();
+
+    Metrics(const Metrics&) = delete;
+    Metrics& operator=(const Metrics&) = delete;
+
+    // Monotonic clock in nanoseconds
+    static uint64_t nowNs();
+
+    void record(MetricStage stage, uint16_t packetType, uint64_t nanos);
+    void increment(MetricCounter counter, uint64_t n = 1);
+
+    // Merged view of one (stage, packet type) across threads
+    struct Summary {
+        uint64_t count = 0;
+        uint64_t mean = 0;
+        uint64_t p50 = 0;
+        uint64_t p90 = 0;
+        uint64_t p99 = 0;
+        uint64_t max = 0;
+    };
+    Summary summarize(MetricStage stage, uint16_t packetType) const;
+    uint64_t counterValue(MetricCounter counter) const;
+
+    // Text snapshot: counters, then one line per non-empty histogram
+    std::string snapshotText() const;
+
+    static const char* stageName(MetricStage stage);
+    static const char* counterName(MetricCounter counter);
+
+    // Dense index of the packet type range (0x0100..0x060F); anything else
+    // (generic Ack/Error included) shares the last slot
+    static constexpr size_t TYPE_SLOTS = 6 * 16 + 1;
+    static size_t typeSlot(uint16_t packetType);
+    static uint16_t slotType(size_t slot);
+
+private:
+    Metrics() = default;
+
+    struct ThreadBlock {
+        std::atomic<LatencyHistogram*> histograms[(size_t)MetricStage::COUNT][TYPE_SLOTS] = {};
+        std::atomic<uint64_t> counters[(size_t)MetricCounter::COUNT] = {};
+    };
+
+    ThreadBlock& local();
+
+    mutable std::mutex registryMutex;  // Guards threads (registration and snapshot)
+    std::vector<ThreadBlock*> threads; // Never freed: threads are few and long-lived
+};
+
+} // namespace hangman
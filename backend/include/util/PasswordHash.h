@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace hangman {
+
+// Salted password hashing: PBKDF2-HMAC-SHA256 with a per-user random salt.
+// Stored format: pbkdf2$<iterations>$<salt hex>$<hash hex>
+// Cost is tunable through the iteration count; every stored hash keeps its
+// own count, so raising it only affects new and upgraded hashes.
+class PasswordHash {
+public:
+    static constexpr uint32_t DEFAULT_ITERATIONS = 20000;
+    static constexpr size_t SALT_SIZE = 16;
+    static constexpr size_t HASH_SIZE = 32;
+
+    // Hash with a fresh random salt
+    static std::string hash(const std::string& password, uint32_t iterations);
+
+    // Check a password against a stored hash. Entries not in pbkdf2 format
+    // are legacy plaintext: compared directly and flagged for an upgrade.
+    static bool verify(const std::string& password, const std::string& stored, bool& needsUpgrade);
+
+    static bool isLegacy(const std::string& stored);
+
+    // Bytes from the kernel CSPRNG (getrandom(2), /dev/urandom as fallback);
+    // for salts and session secrets. Throws if neither is available.
+    static void randomBytes(uint8_t* out, size_t len);
+
+    // Known-answer check of pbkdf2() and a hash()/verify() round trip, run at
+    // startup: a broken KDF would otherwise lock every user out silently
+    static bool selfTest();
+
+    // Raw PBKDF2-HMAC-SHA256 (exposed for benchmarks)
+    static void pbkdf2(const std::string& password, const uint8_t* salt, size_t saltLen, uint32_t iterations,
+                       uint8_t out[HASH_SIZE]);
+};
+
+} // namespace hangman
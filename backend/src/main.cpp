@@ -1,4 +1,5 @@
 #include "network/Server.h"
+#include "util/Logger.h"
 #include <iostream>
 #include <signal.h>
 
@@ -7,13 +8,14 @@ static hangman::Server* g_server = nullptr;
 void signalHandler(int sig) {
     (void)sig;  // Suppress unused parameter warning
     if (g_server) {
-        std::cout << "\nShutting down server..." << std::endl;
+        LOG_INFO("Shutting down server...");
         g_server->stop();
     }
 }
 
 int main(int argc, char* argv[]) {
     int port = 5000;  // Default port
+    hangman::ServerConfig config;
 
     if (argc > 1) {
         try {
@@ -24,13 +26,27 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    // Optional admin/status port (127.0.0.1 only)
+    if (argc > 2) {
+        try {
+            config.adminPort = std::stoi(argv[2]);
+        } catch (...) {
+            std::cerr << "Invalid admin port number" << std::endl;
+            return 1;
+        }
+    }
+
+    // Async logging for the lifetime of the server
+    hangman::Logger::getInstance().start();
+
     try {
-        hangman::Server server(port);
+        hangman::Server server(port, config);
         g_server = &server;
 
         // Initialize server (load database)
         if (!server.initialize("database/account.txt")) {
-            std::cerr << "Failed to initialize server" << std::endl;
+            LOG_ERROR("Failed to initialize server");
+            hangman::Logger::getInstance().stop();
             return 1;
         }
 
@@ -42,9 +58,11 @@ int main(int argc, char* argv[]) {
         server.run();
 
     } catch (const std::exception& e) {
-        std::cerr << "Fatal error: " << e.what() << std::endl;
+        LOG_ERROR("Fatal error: %s", e.what());
+        hangman::Logger::getInstance().stop();
         return 1;
     }
 
+    hangman::Logger::getInstance().stop();
     return 0;
 }
@@ -0,0 +1,54 @@
+#include "network/BufferPool.h"
+
+namespace hangman {
+
+static BufferPool* g_bufferPool = nullptr;
+
+BufferPool& BufferPool::getInstance() {
+    if (!g_bufferPool) {
+        g_bufferPool = new BufferPool();
+    }
+    return *g_bufferPool;
+}
+
+BufferPool::~BufferPool() {
+    for (BufferBlock* block : freeList) {
+        delete block;
+    }
+}
+
+BufferBlock* BufferPool::acquire() {
+    BufferBlock* block;
+    if (!freeList.empty()) {
+        block = freeList.back();
+        freeList.pop_back();
+    } else {
+        block = new BufferBlock;
+    }
+
+    ++inUse;
+    return block;
+}
+
+void BufferPool::release(BufferBlock* block) {
+    if (!block) {
+        return;
+    }
+
+    --inUse;
+    if (freeList.size() < maxCachedBlocks) {
+        freeList.push_back(block);
+    } else {
+        delete block;
+    }
+}
+
+void BufferPool::setMaxCachedBlocks(size_t count) {
+    maxCachedBlocks = count;
+    while (freeList.size() > maxCachedBlocks) {
+        delete freeList.back();
+        freeList.pop_back();
+    }
+}
+
+} // namespace hangman
@@ -1,22 +1,59 @@
 #include "network/Connection.h"
+#include "network/SlabAllocator.h"
+#include "protocol/packet_types.h"
 #include <unistd.h>
 #include <cstring>
 #include <stdexcept>
 #include <cerrno>
 #include <arpa/inet.h>
+#include <sys/uio.h>
+#include <algorithm>
 
 namespace hangman {
 
+static SlabAllocator<sizeof(Connection)>& connectionSlab() {
+    static SlabAllocator<sizeof(Connection)> slab;
+    return slab;
+}
+
+void* Connection::operator new(size_t size) {
+    if (size != sizeof(Connection)) {
+        return ::operator new(size);
+    }
+    return connectionSlab().allocate();
+}
+
+void Connection::operator delete(void* p, size_t size) {
+    if (size != sizeof(Connection)) {
+        ::operator delete(p);
+        return;
+    }
+    connectionSlab().deallocate(p);
+}
+
+size_t Connection::liveConnections() {
+    return connectionSlab().live();
+}
+
 Connection::Connection(int clientFd) : clientFd(clientFd) {
     if (clientFd < 0) {
         throw std::invalid_argument("Invalid client file descriptor");
     }
-    recvBuffer.reserve(RECV_BUFFER_SIZE);
-    sendBuffer.reserve(SEND_BUFFER_SIZE);
+    // Connections are only created on the network thread
+    static uint64_t nextConnectionId = 1;
+    connectionId = nextConnectionId++;
 }
 
 Connection::~Connection() {
     close();
+
+    // Hand queued blocks back to the pool
+    BufferPool& pool = BufferPool::getInstance();
+    for (SendSegment& segment : sendQueue) {
+        if (segment.block) {
+            pool.release(segment.block);
+        }
+    }
 }
 
 void Connection::close() {
@@ -26,28 +63,54 @@ void Connection::close() {
     }
 }
 
-bool Connection::sendData(const uint8_t* data, size_t len) {
-    if (clientFd < 0) {
-        throw std::runtime_error("Connection is closed");
-    }
-
-    // Try to write directly first
+size_t Connection::writeDirect(const uint8_t* data, size_t len) {
     ssize_t written = ::write(clientFd, data, len);
-    
+
     if (written < 0) {
         if (errno == EAGAIN || errno == EWOULDBLOCK) {
             // Buffer is full, queue the data
-            sendBuffer.insert(sendBuffer.end(), data, data + len);
-            return false;
+            return 0;
         }
         // Real error
         close();
         throw std::runtime_error("Failed to write to socket");
     }
+    return (size_t)written;
+}
+
+size_t Connection::writeDirectv(const iovec* iov, int iovCount) {
+    ssize_t written = ::writev(clientFd, iov, iovCount);
+
+    if (written < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
+        close();
+        throw std::runtime_error("Failed to write to socket");
+    }
+    return (size_t)written;
+}
+
+bool Connection::sendData(const uint8_t* data, size_t len) {
+    if (clientFd < 0) {
+        throw std::runtime_error("Connection is closed");
+    }
+
+    if (len == 0) {
+        return sendQueued == 0;
+    }
+
+    // Keep ordering: if something is already queued, append behind it
+    if (sendQueued > 0) {
+        appendToSendQueue(data, len);
+        return false;
+    }
 
-    if ((size_t)written < len) {
+    // Try to write directly first
+    size_t written = writeDirect(data, len);
+    if (written < len) {
         // Partial write, queue the rest
-        sendBuffer.insert(sendBuffer.end(), data + written, data + len);
+        appendToSendQueue(data + written, len - written);
         return false;
     }
 
@@ -55,102 +118,204 @@ bool Connection::sendData(const uint8_t* data, size_t len) {
     return true;
 }
 
-const uint8_t* Connection::getPendingSendData(size_t& outLen) const {
-    if (sendPos >= sendBuffer.size()) {
-        outLen = 0;
-        return nullptr;
+bool Connection::sendShared(const SharedPacket& packet) {
+    if (clientFd < 0) {
+        throw std::runtime_error("Connection is closed");
     }
-    outLen = sendBuffer.size() - sendPos;
-    return sendBuffer.data() + sendPos;
-}
 
-void Connection::confirmSent(size_t bytes) {
-    sendPos += bytes;
-    
-    // Clean up sent data periodically
-    if (sendPos > SEND_BUFFER_SIZE / 2) {
-        if (sendPos >= sendBuffer.size()) {
-            sendBuffer.clear();
-            sendPos = 0;
-        } else {
-            sendBuffer.erase(sendBuffer.begin(), sendBuffer.begin() + sendPos);
-            sendPos = 0;
-        }
+    size_t len = packet->size();
+    if (len == 0) {
+        return sendQueued == 0;
     }
+
+    size_t written = sendQueued > 0 ? 0 : writeDirect(packet->data(), len);
+    if (written < len) {
+        sendQueue.push_back({nullptr, packet, written, len});
+        sendQueued += len - written;
+        return false;
+    }
+    return true;
 }
 
-bool Connection::receiveData() {
+bool Connection::sendFramed(const uint8_t* header, size_t headerLen, const uint8_t* body, size_t bodyLen,
+                            const SharedPacket* owner) {
     if (clientFd < 0) {
         throw std::runtime_error("Connection is closed");
     }
 
-    // Read from socket
-    uint8_t buffer[4096];
-    ssize_t nread = ::read(clientFd, buffer, sizeof(buffer));
+    size_t written = 0;
+    if (sendQueued == 0) {
+        iovec iov[2] = {{const_cast<uint8_t*>(header), headerLen}, {const_cast<uint8_t*>(body), bodyLen}};
+        written = writeDirectv(iov, 2);
+    }
+    if (written >= headerLen + bodyLen) {
+        return true;
+    }
 
-    if (nread < 0) {
-        if (errno == EAGAIN || errno == EWOULDBLOCK) {
-            // No data available right now
-            return true;
+    // Queue what is left: the rest of the header (copied), then the body
+    if (written < headerLen) {
+        appendToSendQueue(header + written, headerLen - written);
+    }
+    size_t bodyWritten = written > headerLen ? written - headerLen : 0;
+    if (owner && body >= (*owner)->data() && body + bodyLen <= (*owner)->data() + (*owner)->size()) {
+        size_t offset = (size_t)(body - (*owner)->data());
+        sendQueue.push_back({nullptr, *owner, offset + bodyWritten, offset + bodyLen});
+        sendQueued += bodyLen - bodyWritten;
+    } else {
+        appendToSendQueue(body + bodyWritten, bodyLen - bodyWritten);
+    }
+    return false;
+}
+
+void Connection::appendToSendQueue(const uint8_t* data, size_t len) {
+    BufferPool& pool = BufferPool::getInstance();
+
+    while (len > 0) {
+        // Fill the last block if it is a copy block with room left
+        if (sendQueue.empty() || !sendQueue.back().block || sendQueue.back().end == BufferBlock::SIZE) {
+            sendQueue.push_back({pool.acquire(), nullptr, 0, 0});
         }
-        // Real error
-        close();
-        return false;
+
+        SendSegment& tail = sendQueue.back();
+        size_t n = std::min(len, BufferBlock::SIZE - tail.end);
+        std::memcpy(tail.block->data + tail.end, data, n);
+        tail.end += n;
+        sendQueued += n;
+        data += n;
+        len -= n;
     }
+}
 
-    if (nread == 0) {
-        // Connection closed by client
-        close();
+bool Connection::flush() {
+    if (clientFd < 0) {
         return false;
     }
 
-    // Append data to receive buffer
-    recvBuffer.insert(recvBuffer.end(), buffer, buffer + nread);
+    BufferPool& pool = BufferPool::getInstance();
+
+    while (sendQueued > 0) {
+        // Gather queued segments
+        iovec iov[MAX_IOV];
+        int iovCount = 0;
+        for (auto it = sendQueue.begin(); it != sendQueue.end() && iovCount < MAX_IOV; ++it) {
+            iov[iovCount].iov_base = const_cast<uint8_t*>(it->bytes() + it->begin);
+            iov[iovCount].iov_len = it->end - it->begin;
+            ++iovCount;
+        }
+
+        ssize_t written = ::writev(clientFd, iov, iovCount);
+        if (written < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return true;  // Socket buffer full, wait for EPOLLOUT
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            close();
+            return false;
+        }
+
+        // Drop fully written segments (blocks go back to the pool), advance into the partial one
+        size_t remaining = (size_t)written;
+        sendQueued -= remaining;
+        while (remaining > 0) {
+            SendSegment& head = sendQueue.front();
+            size_t headLeft = head.end - head.begin;
+            if (remaining < headLeft) {
+                head.begin += remaining;
+                break;
+            }
+            remaining -= headLeft;
+            if (head.block) {
+                pool.release(head.block);
+            }
+            sendQueue.pop_front();
+        }
+    }
+
     return true;
 }
 
-const uint8_t* Connection::getReceivedData(size_t& outLen) const {
-    if (recvPos >= recvBuffer.size()) {
-        outLen = 0;
-        return nullptr;
+bool Connection::receiveData() {
+    if (clientFd < 0) {
+        throw std::runtime_error("Connection is closed");
     }
-    outLen = recvBuffer.size() - recvPos;
-    return recvBuffer.data() + recvPos;
-}
 
-void Connection::confirmProcessed(size_t bytes) {
-    recvPos += bytes;
-    
-    // Clean up processed data periodically
-    if (recvPos > RECV_BUFFER_SIZE / 2) {
-        if (recvPos >= recvBuffer.size()) {
-            recvBuffer.clear();
-            recvPos = 0;
-        } else {
-            recvBuffer.erase(recvBuffer.begin(), recvBuffer.begin() + recvPos);
-            recvPos = 0;
+    // Edge-triggered: keep reading until the socket is drained or the ring is full
+    while (!recvRing.full()) {
+        ssize_t nread = recvRing.readFrom(clientFd);
+
+        if (nread < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                // No data available right now
+                return true;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            // Real error
+            close();
+            return false;
+        }
+
+        if (nread == 0) {
+            // Connection closed by client
+            close();
+            return false;
         }
     }
+
+    return true;
 }
 
-bool Connection::hasCompletePacket() const {
-    // Need at least header size (1 + 2 + 4 = 7 bytes)
-    const size_t HEADER_SIZE = 7;
-    
-    if (recvBuffer.size() - recvPos < HEADER_SIZE) {
+bool Connection::peekPacket(PacketView& out) {
+    if (recvRing.size() < HEADER_SIZE) {
+        return false;
+    }
+
+    // v2 headers carry a request id after the length
+    uint8_t version;
+    recvRing.peek(0, &version, 1);
+    size_t headerSize = version == PROTOCOL_VERSION_V2 ? MAX_HEADER_SIZE : HEADER_SIZE;
+    if (recvRing.size() < headerSize) {
         return false;
     }
 
-    // Parse header to get payload length
-    const uint8_t* data = recvBuffer.data() + recvPos;
+    // Header may straddle the end of the ring: copy it out
+    uint8_t header[MAX_HEADER_SIZE];
+    recvRing.peek(0, header, headerSize);
+
+    uint16_t type;
     uint32_t payloadLen;
-    std::memcpy(&payloadLen, data + 3, 4);
-    
+    uint32_t requestId = 0;
+    std::memcpy(&type, header + 1, 2);
+    std::memcpy(&payloadLen, header + 3, 4);
+    if (headerSize == MAX_HEADER_SIZE) {
+        std::memcpy(&requestId, header + 7, 4);
+    }
+
     // Convert from network byte order
-    payloadLen = ntohl(payloadLen);
-    
+    out.version = version;
+    out.type = ntohs(type);
+    out.payloadLen = ntohl(payloadLen);
+    out.requestId = ntohl(requestId);
+    out.headerSize = headerSize;
+
+    if ((size_t)out.payloadLen > recvRing.capacity() - headerSize) {
+        throw std::runtime_error("Packet exceeds receive buffer");
+    }
+
     // Check if we have the complete packet (header + payload)
-    return recvBuffer.size() - recvPos >= HEADER_SIZE + payloadLen;
+    if (recvRing.size() < headerSize + out.payloadLen) {
+        return false;
+    }
+
+    out.payload = recvRing.contiguous(headerSize, out.payloadLen, recvScratch);
+    return true;
+}
+
+void Connection::confirmProcessed(size_t bytes) {
+    recvRing.consume(bytes);
 }
 
 } // namespace hangman
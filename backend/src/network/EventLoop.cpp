@@ -1,6 +1,7 @@
 // src/network/EventLoop.cpp
 #include "network/EventLoop.h"
 #include <sys/epoll.h>
+#include <sys/timerfd.h>
 #include <unistd.h>
 #include <stdexcept>
 #include <cstring>
@@ -46,13 +47,20 @@ void EventLoop::addFd(int fd, EventCallback callback, uint32_t events)
         throw std::runtime_error("Failed to add fd to epoll");
     }
 
-    callbacks[fd] = callback;
+    if ((size_t)fd >= callbacks.size())
+    {
+        callbacks.resize(fd + 1);
+    }
+    callbacks[fd] = std::move(callback);
 }
 
 void EventLoop::removeFd(int fd)
 {
     epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
-    callbacks.erase(fd);
+    if (fd >= 0 && (size_t)fd < callbacks.size())
+    {
+        callbacks[fd] = nullptr;
+    }
 }
 
 void EventLoop::modifyFd(int fd, uint32_t events)
@@ -78,6 +86,44 @@ void EventLoop::modifyFd(int fd, uint32_t events)
     }
 }
 
+int EventLoop::addTimer(uint32_t intervalMs, std::function<void()> callback)
+{
+    int timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd < 0)
+    {
+        throw std::runtime_error("Failed to create timerfd");
+    }
+
+    itimerspec spec;
+    std::memset(&spec, 0, sizeof(spec));
+    spec.it_interval.tv_sec = intervalMs / 1000;
+    spec.it_interval.tv_nsec = (long)(intervalMs % 1000) * 1000000;
+    spec.it_value = spec.it_interval;
+    if (timerfd_settime(timerFd, 0, &spec, nullptr) < 0)
+    {
+        close(timerFd);
+        throw std::runtime_error("Failed to arm timerfd");
+    }
+
+    addFd(timerFd, [timerFd, callback](uint32_t)
+          {
+              // Drain the expiration count (edge-triggered), then run once
+              // even if several intervals elapsed
+              uint64_t expirations;
+              while (read(timerFd, &expirations, sizeof(expirations)) > 0)
+              {
+              }
+              callback();
+          });
+    return timerFd;
+}
+
+void EventLoop::removeTimer(int timerFd)
+{
+    removeFd(timerFd);
+    close(timerFd);
+}
+
 void EventLoop::run()
 {
     running = true;
@@ -97,11 +143,24 @@ void EventLoop::run()
         for (int i = 0; i < nfds; ++i)
         {
             int fd = events[i].data.fd;
+            uint32_t ready = 0;
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR | EPOLLRDHUP))
+            {
+                ready |= EVENT_READ;
+            }
+            if (events[i].events & EPOLLOUT)
+            {
+                ready |= EVENT_WRITE;
+            }
 
-            auto it = callbacks.find(fd);
-            if (it != callbacks.end())
+            // Slot may have been cleared by an earlier callback in this batch
+            if ((size_t)fd < callbacks.size() && callbacks[fd])
             {
-                it->second(); // Gọi callback
+                // Run a copy: the callback may addFd (resizing the table) or
+                // removeFd its own slot while it executes. Captures are small
+                // ([this, fd]), so the copy stays in std::function's inline buffer.
+                EventCallback callback = callbacks[fd];
+                callback(ready); // Gọi callback
             }
         }
     }
@@ -0,0 +1,90 @@
+#include "network/RingBuffer.h"
+#include <sys/uio.h>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+#include <cerrno>
+
+namespace hangman {
+
+RingBuffer::~RingBuffer() {
+    BufferPool::getInstance().release(block);
+}
+
+ssize_t RingBuffer::readFrom(int fd) {
+    size_t space = freeSpace();
+    if (space == 0) {
+        return 0;
+    }
+
+    if (!block) {
+        block = BufferPool::getInstance().acquire();
+    }
+
+    // Free space is [tail, head + capacity), possibly split at the end of storage
+    size_t start = tail & MASK;
+    size_t firstLen = std::min(space, capacity() - start);
+
+    iovec iov[2];
+    iov[0].iov_base = block->data + start;
+    iov[0].iov_len = firstLen;
+    iov[1].iov_base = block->data;
+    iov[1].iov_len = space - firstLen;
+
+    ssize_t n = ::readv(fd, iov, iov[1].iov_len > 0 ? 2 : 1);
+    if (n > 0) {
+        tail += (size_t)n;
+    } else {
+        // Spurious wakeup or EOF: do not keep a block for an empty ring
+        int savedErrno = errno;
+        releaseIfEmpty();
+        errno = savedErrno;
+    }
+    return n;
+}
+
+void RingBuffer::peek(size_t offset, uint8_t* dst, size_t len) const {
+    if (offset + len > size()) {
+        throw std::out_of_range("RingBuffer: peek past end of data");
+    }
+
+    size_t start = (head + offset) & MASK;
+    size_t firstLen = std::min(len, capacity() - start);
+    std::memcpy(dst, block->data + start, firstLen);
+    std::memcpy(dst + firstLen, block->data, len - firstLen);
+}
+
+const uint8_t* RingBuffer::contiguous(size_t offset, size_t len, std::vector<uint8_t>& scratch) const {
+    if (offset + len > size()) {
+        throw std::out_of_range("RingBuffer: view past end of data");
+    }
+
+    size_t start = (head + offset) & MASK;
+    if (start + len <= capacity()) {
+        return block->data + start;
+    }
+
+    // Range wraps around: stitch both halves together
+    scratch.resize(len);
+    peek(offset, scratch.data(), len);
+    return scratch.data();
+}
+
+void RingBuffer::consume(size_t len) {
+    if (len > size()) {
+        throw std::out_of_range("RingBuffer: consume past end of data");
+    }
+    head += len;
+    releaseIfEmpty();
+}
+
+void RingBuffer::releaseIfEmpty() {
+    if (block && head == tail) {
+        BufferPool::getInstance().release(block);
+        block = nullptr;
+        head = 0;
+        tail = 0;
+    }
+}
+
+} // namespace hangman
@@ -1,36 +1,64 @@
 #include "network/Server.h"
 #include "network/Socket.h"
+#include "network/BufferPool.h"
 #include "threading/Task.h"
 #include "threading/CallbackQueue.h"
 #include "service/AuthService.h"
+#include "service/RoomService.h"
+#include "service/MatchService.h"
+#include "service/StateSnapshot.h"
 #include "protocol/packets.h"
 #include "protocol/bytebuffer.h"
-#include <iostream>
+#include "util/Logger.h"
+#include "util/Metrics.h"
 #include <iomanip>
+#include <algorithm>
 #include <cstring>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
 
 namespace hangman
 {
+    // Reply to login/register requests shed by the rate limiters
+    static const char *const RATE_LIMITED_MESSAGE = "Too many attempts, try again later";
+
     // CONSTRUCTOR: CREATE LISTENING SOCKET
-    Server::Server(int port)
-        : port(port), listenFd(-1), running(false),
+    Server::Server(int port, const ServerConfig &config)
+        : port(port), config(config), listenFd(-1), reserveFd(-1), adminFd(-1), startedAt(Metrics::nowNs()), running(false),
           eventLoop(std::make_unique<EventLoop>()),
+          authAddressLimiter(config.authPerAddressRate, config.authPerAddressBurst),
+          loginUserLimiter(config.loginPerUserRate, config.loginPerUserBurst),
           taskQueue(std::make_unique<TaskQueue>()),
-          callbackQueue(std::make_unique<CallbackQueue>())
+          callbackQueue(std::make_unique<CallbackQueue>()),
+          authQueue(std::make_unique<TaskQueue>())
     {
 
         // Create listening socket
         listenFd = Socket::createListeningSocket(port);
-        std::cout << "Server listening on port " << port << std::endl;
+        if (config.deferAcceptSeconds > 0)
+        {
+            Socket::setDeferAccept(listenFd, config.deferAcceptSeconds);
+        }
+        reserveFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        LOG_INFO("Server listening on port %d", port);
 
         // Register listening fd with event loop
-        eventLoop->addFd(listenFd, [this]()
+        eventLoop->addFd(listenFd, [this](uint32_t)
                          { handleAccept(); });
 
+        // Admin endpoint: local only, served by the same event loop
+        if (config.adminPort > 0)
+        {
+            adminFd = Socket::createListeningSocket(config.adminPort, true);
+            eventLoop->addFd(adminFd, [this](uint32_t)
+                             { handleAdminAccept(); });
+            LOG_INFO("Admin status on 127.0.0.1:%d", config.adminPort);
+        }
+
         // Register callback queue notification fd with event loop
-        eventLoop->addFd(callbackQueue->getNotificationFd(), [this]()
+        eventLoop->addFd(callbackQueue->getNotificationFd(), [this](uint32_t)
                          { handleCallbacks(); });
     }
 
@@ -41,17 +69,47 @@ namespace hangman
         {
             Socket::closeSocket(listenFd);
         }
+        if (reserveFd >= 0)
+        {
+            close(reserveFd);
+        }
+        if (adminFd >= 0)
+        {
+            Socket::closeSocket(adminFd);
+        }
     }
 
     bool Server::initialize(const std::string& dbPath)
     {
+        // Stored hashes are checked with our own PBKDF2: refuse to start
+        // rather than reject every login
+        if (!PasswordHash::selfTest()) {
+            LOG_ERROR("Password hash self-test failed");
+            return false;
+        }
+        AuthService::getInstance().setHashIterations(config.passwordIterations);
+
         // Load database
         if (!AuthService::getInstance().loadDatabase(dbPath)) {
-            std::cerr << "Failed to load database from: " << dbPath << std::endl;
+            LOG_ERROR("Failed to load database from: %s", dbPath.c_str());
             return false;
         }
 
-        std::cout << "Database loaded successfully from: " << dbPath << std::endl;
+        LOG_INFO("Database loaded successfully from: %s", dbPath.c_str());
+
+        // Live state from the last run (sessions, rooms, matches)
+        if (!config.snapshotPath.empty()) {
+            StateSnapshot::load(config.snapshotPath);
+        }
+
+        // Restored sessions wait for their clients like dropped ones
+        for (const std::string &token : AuthService::getInstance().getDetachedTokens()) {
+            Session session;
+            if (AuthService::getInstance().getSessionInfo(token, session)) {
+                RoomService::getInstance().rebindClient(session.username, -1, session.clientFd);
+                detachedSessions[session.clientFd] = DetachedSession{session.username, token, Metrics::nowNs(), {}};
+            }
+        }
         initialized = true;
         return true;
     }
@@ -60,21 +118,96 @@ namespace hangman
     {
         running = true;
 
-        // Start worker thread
-        workerThread = std::thread([this]()
-                                   { workerThreadLoop(); });
+        // Start worker pool
+        size_t workerCount = config.workerThreads > 0 ? config.workerThreads : 1;
+        for (size_t i = 0; i < workerCount; ++i)
+        {
+            workerThreads.emplace_back([this]()
+                                       { workerThreadLoop(*taskQueue); });
+        }
+        size_t authCount = config.authThreads > 0 ? config.authThreads : 1;
+        for (size_t i = 0; i < authCount; ++i)
+        {
+            authThreads.emplace_back([this]()
+                                     { workerThreadLoop(*authQueue); });
+        }
+
+        // Periodic snapshot, taken by a worker on the lobby actor
+        int snapshotTimer = -1;
+        if (!config.snapshotPath.empty() && config.snapshotIntervalSec > 0)
+        {
+            snapshotTimer = eventLoop->addTimer(config.snapshotIntervalSec * 1000, [this]()
+                                                { taskQueue->push(std::make_shared<SnapshotTask>(config.snapshotPath)); });
+        }
+
+        // Upgraded password hashes go to disk in batches, off the login path
+        int usersTimer = -1;
+        if (config.userFlushIntervalSec > 0)
+        {
+            usersTimer = eventLoop->addTimer(config.userFlushIntervalSec * 1000, [this]()
+                                             {
+                                                 if (AuthService::getInstance().hasUnsavedUsers())
+                                                 {
+                                                     taskQueue->push(std::make_shared<FlushUsersTask>());
+                                                 }
+                                             });
+        }
+
+        // Detached sessions past their grace period are logged out
+        int resumeTimer = eventLoop->addTimer(1000, [this]()
+                                              { expireDetachedSessions(); });
 
         // Run event loop (Main thread is blocked here)
         eventLoop->run();
 
-        // Stop worker thread
+        eventLoop->removeTimer(resumeTimer);
+        if (usersTimer >= 0)
+        {
+            eventLoop->removeTimer(usersTimer);
+        }
+        if (snapshotTimer >= 0)
+        {
+            eventLoop->removeTimer(snapshotTimer);
+        }
+
+        // Stop worker and auth pools
         taskQueue->stop();
-        if (workerThread.joinable())
+        authQueue->stop();
+        for (std::thread &worker : workerThreads)
         {
-            workerThread.join();
+            if (worker.joinable())
+            {
+                worker.join();
+            }
         }
+        workerThreads.clear();
+        for (std::thread &worker : authThreads)
+        {
+            if (worker.joinable())
+            {
+                worker.join();
+            }
+        }
+        authThreads.clear();
+
+        // Final snapshot once no worker can change state any more
+        if (!config.snapshotPath.empty())
+        {
+            StateSnapshot::save(config.snapshotPath);
+        }
+        AuthService::getInstance().flushUsers();
 
-        std::cout << "Server stopped" << std::endl;
+        // Final metrics snapshot, one log line per metric
+        std::string snapshot = Metrics::getInstance().snapshotText();
+        size_t lineStart = 0;
+        while (lineStart < snapshot.size())
+        {
+            size_t lineEnd = snapshot.find('\n', lineStart);
+            LOG_INFO("metrics %.*s", (int)(lineEnd - lineStart), snapshot.c_str() + lineStart);
+            lineStart = lineEnd + 1;
+        }
+
+        LOG_INFO("Server stopped");
     }
 
     void Server::stop()
@@ -84,129 +217,450 @@ namespace hangman
     }
 
     void Server::handleAccept()
-    {   // DRAIN THE QUEUE
+    {   // DRAIN THE QUEUE (edge-triggered: accept until EAGAIN)
+        size_t accepted = 0;
         while (true)
         {
-            int clientFd = Socket::acceptConnection(listenFd); // RETURN NEW CLIENT FD IF THERE IS A PENDING CONNECTION
+            sockaddr_in peer;
+            int clientFd = Socket::acceptConnection(listenFd, &peer); // RETURN NEW CLIENT FD IF THERE IS A PENDING CONNECTION
             if (clientFd < 0)
             {
+                if ((errno == EMFILE || errno == ENFILE) && reserveFd >= 0)
+                {
+                    // Out of fds: the pending connection would keep the listen
+                    // socket readable forever. Free the spare fd, accept and
+                    // close the client, then take the spare back.
+                    close(reserveFd);
+                    int shedFd = Socket::acceptConnection(listenFd);
+                    if (shedFd >= 0)
+                    {
+                        Socket::closeSocket(shedFd);
+                    }
+                    reserveFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+                    LOG_WARN("Out of file descriptors, shedding connection");
+                    continue;
+                }
                 break; // No more pending connections
             }
 
-            std::cout << "New client connection: fd=" << clientFd << std::endl;
+            if (config.tcpNoDelay)
+            {
+                Socket::setNoDelay(clientFd);
+            }
+            if (config.socketSendBuffer > 0 || config.socketRecvBuffer > 0)
+            {
+                Socket::setBufferSizes(clientFd, config.socketSendBuffer, config.socketRecvBuffer);
+            }
 
             try
             {
-                // Create connection wrapper
-                auto conn = std::make_shared<Connection>(clientFd);
-                connections[clientFd] = conn; // STORE THE CONNECTION
+                // Create connection wrapper (slab-allocated) and store it in the fd table
+                if ((size_t)clientFd >= connections.size())
+                {
+                    connections.resize(clientFd + 1);
+                }
+                connections[clientFd] = ConnectionPtr(new Connection(clientFd));
+                ++connectionCount;
+                Connection *conn = connections[clientFd].get();
+                conn->setPeerAddress(peer.sin_addr.s_addr);
 
                 // Register with event loop
-                eventLoop->addFd(clientFd, [this, clientFd]()
-                                 { handleClientRead(clientFd); });
+                eventLoop->addFd(clientFd, [this, clientFd](uint32_t events)
+                                 { handleClientEvent(clientFd, events); });
+                conn->setRegisteredEvents(EventLoop::EVENT_READ);
+                ++accepted;
             }
             catch (const std::exception &e)
             {
-                std::cerr << "Failed to accept connection: " << e.what() << std::endl;
-                Socket::closeSocket(clientFd);
+                LOG_ERROR("Failed to accept connection: %s", e.what());
+                if (getConnection(clientFd)) // Connection closes its own fd
+                {
+                    closeConnection(clientFd);
+                }
+                else
+                {
+                    Socket::closeSocket(clientFd);
+                }
             }
         }
+
+        // One line per accept batch instead of one flushed line per client
+        if (accepted > 0)
+        {
+            Metrics::getInstance().increment(MetricCounter::CONNECTIONS_ACCEPTED, accepted);
+            LOG_INFO("Accepted %zu client(s), %zu connected", accepted, connectionCount);
+        }
     }
 
     // HANDLE: This socket is ready to read
     void Server::handleClientRead(int clientFd)
     {
-        auto it = connections.find(clientFd);
-        if (it == connections.end())
+        Connection *conn = getConnection(clientFd);
+        if (!conn)
         {
             return;
         }
 
-        auto &conn = it->second;
-
         try
         {
-            // Read from socket
-            if (!conn->receiveData())
-            {
-                // Connection closed
-                std::cout << "Client disconnected: fd=" << clientFd << std::endl;
-                eventLoop->removeFd(clientFd);
-                connections.erase(it);
-                return;
-            }
-
-            // Process complete packets
-            while (conn->hasCompletePacket())
+            while (true)
             {
-                size_t dataLen;
-                const uint8_t *data = conn->getReceivedData(dataLen);
-
-                if (data == nullptr || dataLen == 0)
+                // Read from socket into the receive ring
+                if (!conn->receiveData())
                 {
-                    break;
+                    // Connection closed
+                    LOG_INFO("Client disconnected: fd=%d", clientFd);
+                    closeConnection(clientFd);
+                    return;
                 }
+                bool ringFull = conn->isReceiveBufferFull();
+
+                // Process complete packets (stop early if backpressure kicked in)
+                PacketView packet;
+                while (!conn->isReadPaused() && conn->peekPacket(packet))
+                {
+                    // Verify header
+                    if (packet.version != PROTOCOL_VERSION && packet.version != PROTOCOL_VERSION_V2)
+                    {
+                        LOG_WARN("Invalid protocol version from fd=%d", clientFd);
+                        conn->confirmProcessed(Connection::HEADER_SIZE);
+                        continue;
+                    }
+                    // Pushes follow the newest version the client speaks
+                    if (packet.version > conn->getProtocolVersion())
+                    {
+                        conn->setProtocolVersion(packet.version);
+                    }
+
+                    Metrics &metrics = Metrics::getInstance();
+                    metrics.increment(MetricCounter::PACKETS_IN);
+                    metrics.increment(MetricCounter::BYTES_IN, packet.headerSize + packet.payloadLen);
 
-                // Extract header
-                ByteBuffer headerBuf; // NULL
-                headerBuf.buf.insert(headerBuf.buf.begin(), data, data + 7);
+                    processPacket(clientFd, packet);
 
-                uint8_t version = headerBuf.read_u8();
-                uint16_t packetType = headerBuf.read_u16(); // Read packetType
-                uint32_t payloadLen = headerBuf.read_u32();
+                    // An inline reply may have closed the connection (write
+                    // error, send hard limit): conn and its ring are gone
+                    if (getConnection(clientFd) != conn)
+                    {
+                        return;
+                    }
+
+                    // Mark packet as processed
+                    conn->confirmProcessed(packet.headerSize + packet.payloadLen);
+                }
 
-                // Verify header
-                if (version != PROTOCOL_VERSION)
+                // Edge-triggered: if the ring filled up, the socket may still
+                // hold data that will not raise another event
+                if (!ringFull || conn->isReadPaused())
                 {
-                    std::cerr << "Invalid protocol version" << std::endl;
-                    conn->confirmProcessed(7);
-                    continue;
+                    break;
                 }
+            }
+        }
+        catch (const std::exception &e)
+        {
+            LOG_ERROR("Error handling client read: %s", e.what());
+            closeConnection(clientFd);
+        }
+    }
 
-                // Process packet (7 = header size)
-                processPacket(clientFd, packetType, data + 7, payloadLen);
+    // HANDLE: Any event on a client socket (readable and/or writable)
+    void Server::handleClientEvent(int clientFd, uint32_t events)
+    {
+        Connection *conn = getConnection(clientFd);
+        if (!conn)
+        {
+            return;
+        }
+        bool wasPaused = conn->isReadPaused();
 
-                // Mark packet as processed
-                conn->confirmProcessed(7 + payloadLen);
+        // Flush first: draining the send queue may lift backpressure
+        if (events & EventLoop::EVENT_WRITE)
+        {
+            handleClientWrite(clientFd);
+            conn = getConnection(clientFd);
+            if (!conn)
+            {
+                return;
             }
         }
-        catch (const std::exception &e)
+
+        // One-shot connections (admin dump) only write until drained
+        if (conn->isCloseAfterFlush())
+        {
+            return;
+        }
+
+        // Read on EPOLLIN, or right after a resume to drain buffered packets
+        if (!conn->isReadPaused() && ((events & EventLoop::EVENT_READ) || wasPaused))
         {
-            std::cerr << "Error handling client read: " << e.what() << std::endl;
-            eventLoop->removeFd(clientFd);
-            connections.erase(it);
+            handleClientRead(clientFd);
         }
     }
 
     // HANDLE: This socket is ready to write (socket buffer has space)
     void Server::handleClientWrite(int clientFd)
     {
-        auto it = connections.find(clientFd);
-        if (it == connections.end())
+        Connection *conn = getConnection(clientFd);
+        if (!conn)
+        {
+            return;
+        }
+        if (!conn->hasPendingSend())
         {
             return;
         }
 
-        auto &conn = it->second;
+        if (!conn->flush())
+        {
+            LOG_ERROR("Error handling client write: fd=%d", clientFd);
+            closeConnection(clientFd);
+            return;
+        }
+        if (conn->isCloseAfterFlush() && !conn->hasPendingSend())
+        {
+            closeConnection(clientFd);
+            return;
+        }
 
-        try
+        // Resume reading once the slow client has caught up
+        if (conn->isReadPaused() && conn->pendingSendBytes() <= config.sendLimits.lowWatermark)
+        {
+            conn->setReadPaused(false);
+        }
+        updateInterest(*conn);
+    }
+
+    // Register EPOLLIN unless paused, EPOLLOUT only while data is queued
+    void Server::updateInterest(Connection &conn)
+    {
+        uint32_t events = 0;
+        if (!conn.isReadPaused())
+        {
+            events |= EventLoop::EVENT_READ;
+        }
+        if (conn.hasPendingSend())
+        {
+            events |= EventLoop::EVENT_WRITE;
+        }
+
+        if (events != conn.getRegisteredEvents())
+        {
+            eventLoop->modifyFd(conn.getFd(), events);
+            conn.setRegisteredEvents(events);
+        }
+    }
+
+    void Server::closeConnection(int clientFd)
+    {
+        Connection *conn = getConnection(clientFd);
+        if (!conn)
+        {
+            return;
+        }
+        if (conn->hasSession())
+        {
+            detachSession(clientFd, conn->getSessionUser(), conn->getSessionToken());
+        }
+
+        eventLoop->removeFd(clientFd);
+        connections[clientFd].reset();
+        --connectionCount;
+        Metrics::getInstance().increment(MetricCounter::CONNECTIONS_CLOSED);
+    }
+
+    // The session outlives its connection: notifications are held under the
+    // detached id until the client resumes or the grace period runs out
+    void Server::detachSession(int clientFd, const std::string &username, const std::string &token)
+    {
+        int detachedFd = AuthService::getInstance().detachSession(token, clientFd);
+        if (detachedFd == -1)
+        {
+            return; // Logged out or already resumed elsewhere
+        }
+        RoomService::getInstance().rebindClient(username, clientFd, detachedFd);
+        // A resume that lost its connection before delivery keeps the outbox
+        DetachedSession &detached = detachedSessions[detachedFd];
+        detached.username = username;
+        detached.token = token;
+        detached.detachedAt = Metrics::nowNs();
+        LOG_INFO("Session of %s detached from fd=%d", username.c_str(), clientFd);
+    }
+
+    // Send what the client missed right after its resume result
+    void Server::replayOutbox(int detachedFd, int clientFd)
+    {
+        auto it = detachedSessions.find(detachedFd);
+        if (it == detachedSessions.end())
+        {
+            return;
+        }
+        std::deque<SharedPacket> outbox = std::move(it->second.outbox);
+        detachedSessions.erase(it);
+        for (const SharedPacket &packet : outbox)
+        {
+            sendPacket(clientFd, *packet, &packet);
+        }
+        Metrics::getInstance().increment(MetricCounter::SESSIONS_RESUMED);
+        LOG_INFO("Session resumed on fd=%d, replayed %zu notification(s)", clientFd, outbox.size());
+    }
+
+    void Server::expireDetachedSessions()
+    {
+        uint64_t cutoff = Metrics::nowNs() - (uint64_t)config.resumeGraceSec * 1000000000ull;
+        for (auto it = detachedSessions.begin(); it != detachedSessions.end();)
+        {
+            if (it->second.detachedAt > cutoff)
+            {
+                ++it;
+                continue;
+            }
+            if (AuthService::getInstance().expireSession(it->second.token, it->first))
+            {
+                RoomService::getInstance().rebindClient(it->second.username, it->first, -1);
+                LOG_INFO("Session of %s expired without resume", it->second.username.c_str());
+            }
+            it = detachedSessions.erase(it);
+        }
+    }
+
+    // HANDLE: Operator connected to the admin port: send the status dump, then close
+    void Server::handleAdminAccept()
+    {
+        while (true)
         {
-            size_t pendingLen;
-            const uint8_t *pending = conn->getPendingSendData(pendingLen);
+            sockaddr_in peer;
+            int fd = Socket::acceptConnection(adminFd, &peer);
+            if (fd < 0)
+            {
+                break;
+            }
 
-            if (pending != nullptr && pendingLen > 0)
+            try
+            {
+                if ((size_t)fd >= connections.size())
+                {
+                    connections.resize(fd + 1);
+                }
+                connections[fd] = ConnectionPtr(new Connection(fd));
+                ++connectionCount;
+                Connection *conn = connections[fd].get();
+                conn->setPeerAddress(peer.sin_addr.s_addr);
+                conn->setCloseAfterFlush(true);
+
+                eventLoop->addFd(fd, [this, fd](uint32_t events)
+                                 { handleClientEvent(fd, events); });
+                conn->setRegisteredEvents(EventLoop::EVENT_READ);
+
+                std::string report = buildStatusReport();
+                conn->sendData(reinterpret_cast<const uint8_t *>(report.data()), report.size());
+                if (!conn->hasPendingSend())
+                {
+                    closeConnection(fd);
+                    continue;
+                }
+                updateInterest(*conn);
+            }
+            catch (const std::exception &e)
             {
-                ssize_t sent = write(clientFd, pending, pendingLen);
-                if (sent > 0)
+                LOG_ERROR("Admin connection failed: %s", e.what());
+                if (getConnection(fd))
                 {
-                    conn->confirmSent(sent);
+                    closeConnection(fd);
+                }
+                else
+                {
+                    Socket::closeSocket(fd);
                 }
             }
         }
-        catch (const std::exception &e)
+    }
+
+    // Plain-text snapshot of the server state (network thread)
+    std::string Server::buildStatusReport() const
+    {
+        static constexpr size_t MAX_LISTED = 1000; // Per section, keeps the dump bounded
+        static const char *playerStates[] = {"FREE", "PREPARING", "READY", "IN_GAME"};
+
+        std::string out;
+        char line[512];
+        auto append = [&out, &line](int n)
         {
-            std::cerr << "Error handling client write: " << e.what() << std::endl;
+            if (n > 0)
+            {
+                out.append(line, std::min((size_t)n, sizeof(line) - 1));
+            }
+        };
+
+        BufferPool &pool = BufferPool::getInstance();
+        append(snprintf(line, sizeof(line),
+                        "# server\nuptime_s %llu\nconnections %zu\ndetached_sessions %zu\nbuffer_blocks in_use=%zu cached=%zu\n"
+                        "workers %zu\ntask_queue_depth %zu\ntask_actors %zu\nauth_workers %zu\nauth_queue_depth %zu\n"
+                        "callback_queue_depth %zu\nlog_dropped %llu\n",
+                        (unsigned long long)((Metrics::nowNs() - startedAt) / 1000000000ull), connectionCount, detachedSessions.size(),
+                        pool.blocksInUse(), pool.blocksCached(), workerThreads.size(), taskQueue->size(),
+                        taskQueue->actorCount(), authThreads.size(), authQueue->size(), callbackQueue->size(),
+                        (unsigned long long)Logger::getInstance().droppedCount()));
+
+        append(snprintf(line, sizeof(line), "\n# connections (%zu)\n", connectionCount));
+        size_t listed = 0;
+        for (size_t fd = 0; fd < connections.size() && listed < MAX_LISTED; ++fd)
+        {
+            const Connection *conn = connections[fd].get();
+            if (!conn)
+            {
+                continue;
+            }
+            char peer[INET_ADDRSTRLEN] = "?";
+            uint32_t addr = conn->getPeerAddress();
+            inet_ntop(AF_INET, &addr, peer, sizeof(peer));
+            append(snprintf(line, sizeof(line), "fd=%zu peer=%s pending_send=%zu read_paused=%d%s\n",
+                            fd, peer, conn->pendingSendBytes(), conn->isReadPaused() ? 1 : 0,
+                            conn->isCloseAfterFlush() ? " admin" : ""));
+            ++listed;
         }
+
+        std::vector<Session> sessions = AuthService::getInstance().getAllSessions();
+        append(snprintf(line, sizeof(line), "\n# sessions (%zu)\n", sessions.size()));
+        for (size_t i = 0; i < sessions.size() && i < MAX_LISTED; ++i)
+        {
+            const Session &session = sessions[i];
+            append(snprintf(line, sizeof(line), "%s fd=%d wins=%u points=%u\n", session.username.c_str(),
+                            session.clientFd, session.wins, session.total_points));
+        }
+
+        std::vector<Room> rooms = RoomService::getInstance().getAllRooms();
+        append(snprintf(line, sizeof(line), "\n# rooms (%zu)\n", rooms.size()));
+        for (size_t i = 0; i < rooms.size() && i < MAX_LISTED; ++i)
+        {
+            const Room &room = rooms[i];
+            std::string players;
+            for (const auto &player : room.players)
+            {
+                players += (players.empty() ? "" : ",") + player.username + "(" + playerStates[(int)player.state] + ")";
+            }
+            append(snprintf(line, sizeof(line), "id=%u name=%s host=%s state=%s players=%s\n", room.id,
+                            room.name.c_str(), room.host_username.c_str(),
+                            room.state == RoomState::PLAYING ? "PLAYING" : "WAITING", players.c_str()));
+        }
+
+        std::vector<Match> matches = MatchService::getInstance().getActiveMatches();
+        append(snprintf(line, sizeof(line), "\n# matches (%zu)\n", matches.size()));
+        for (size_t i = 0; i < matches.size() && i < MAX_LISTED; ++i)
+        {
+            const Match &match = matches[i];
+            std::string players;
+            for (const auto &pair : match.playerStates)
+            {
+                players += (players.empty() ? "" : ",") + pair.first + "(lives=" +
+                           std::to_string(pair.second.remainingAttempts) + (pair.second.finished ? ",done" : "") + ")";
+            }
+            append(snprintf(line, sizeof(line), "room=%u players=%s\n", match.roomId, players.c_str()));
+        }
+
+        out += "\n# metrics\n";
+        out += Metrics::getInstance().snapshotText();
+        return out;
     }
 
     void Server::handleCallbacks()
@@ -222,238 +676,490 @@ namespace hangman
             }
             catch (const std::exception &e)
             {
-                std::cerr << "Error executing callback: " << e.what() << std::endl;
+                LOG_ERROR("Error executing callback: %s", e.what());
             }
         }
     }
 
-    void Server::processPacket(int clientFd, uint16_t packetType, const uint8_t *data, size_t len)
+    void Server::processPacket(int clientFd, const PacketView &packet)
     {
-        if (len == 0)
+        if (packet.payloadLen == 0)
         {
             return;
         }
 
         try
         {
-            ByteBuffer buf;
-            buf.buf.insert(buf.buf.end(), data, data + len);
+            // Reuse one payload buffer on the network thread (no per-packet allocation)
+            ByteBuffer &buf = packetBuf;
+            buf.buf.assign(packet.payload, packet.payload + packet.payloadLen);
+            buf.rpos = 0;
 
-            switch (packetType) {
+            switch (packet.type) {
                 case static_cast<uint16_t>(PacketType::C2S_Register): {
                     C2S_Register registerReq = C2S_Register::from_payload(buf);
+                    if (!allowAuthRequest(clientFd, nullptr)) {
+                        sendResponse(clientFd, S2C_RegisterResult{ResultCode::FAIL, RATE_LIMITED_MESSAGE}.to_bytes(),
+                                     packet.version, packet.requestId);
+                        break;
+                    }
                     auto task = std::make_shared<RegisterTask>(clientFd, registerReq); // Create a task (who, type)
-                    taskQueue->push(task);
-                    std::cout << "Queued RegisterTask for client " << clientFd << std::endl;
+                    dispatchTask(task, packet);
+                    LOG_DEBUG("Queued RegisterTask for client %d", clientFd);
                     break;
                 }
 
                 case static_cast<uint16_t>(PacketType::C2S_Login): {
                     C2S_Login loginReq = C2S_Login::from_payload(buf);
+                    if (!allowAuthRequest(clientFd, &loginReq.username)) {
+                        sendResponse(clientFd, S2C_LoginResult{ResultCode::FAIL, RATE_LIMITED_MESSAGE, "", 0, 0}.to_bytes(),
+                                     packet.version, packet.requestId);
+                        break;
+                    }
                     auto task = std::make_shared<LoginTask>(clientFd, loginReq);
-                    taskQueue->push(task);
-                    std::cout << "Queued LoginTask for client " << clientFd << std::endl;
+                    dispatchTask(task, packet);
+                    LOG_DEBUG("Queued LoginTask for client %d", clientFd);
                     break;
                 }
 
                 case static_cast<uint16_t>(PacketType::C2S_Logout): {
                     C2S_Logout logoutReq = C2S_Logout::from_payload(buf);
                     auto task = std::make_shared<LogoutTask>(clientFd, logoutReq);
-                    taskQueue->push(task);
-                    std::cout << "Queued LogoutTask for client " << clientFd << std::endl;
+                    dispatchTask(task, packet);
+                    LOG_DEBUG("Queued LogoutTask for client %d", clientFd);
+                    break;
+                }
+
+                case static_cast<uint16_t>(PacketType::C2S_ResumeSession): {
+                    C2S_ResumeSession resumeReq = C2S_ResumeSession::from_payload(buf);
+                    if (!allowAuthRequest(clientFd, nullptr)) {
+                        sendResponse(clientFd, S2C_ResumeResult{ResultCode::FAIL, RATE_LIMITED_MESSAGE, "", 0, 0}.to_bytes(),
+                                     packet.version, packet.requestId);
+                        break;
+                    }
+                    auto task = std::make_shared<ResumeSessionTask>(clientFd, resumeReq);
+                    dispatchTask(task, packet);
                     break;
                 }
 
                 case static_cast<uint16_t>(PacketType::C2S_CreateRoom): {
                     C2S_CreateRoom createRoomReq = C2S_CreateRoom::from_payload(buf);
                     auto task = std::make_shared<CreateRoomTask>(clientFd, createRoomReq);
-                    taskQueue->push(task);
-                    std::cout << "Queued CreateRoomTask for client " << clientFd << std::endl;
+                    dispatchTask(task, packet);
+                    LOG_DEBUG("Queued CreateRoomTask for client %d", clientFd);
                     break;
                 }
 
                 case static_cast<uint16_t>(PacketType::C2S_LeaveRoom): {
                     C2S_LeaveRoom leaveRoomReq = C2S_LeaveRoom::from_payload(buf);
                     auto task = std::make_shared<LeaveRoomTask>(clientFd, leaveRoomReq);
-                    taskQueue->push(task);
-                    std::cout << "Queued LeaveRoomTask for client " << clientFd << std::endl;
+                    dispatchTask(task, packet);
+                    LOG_DEBUG("Queued LeaveRoomTask for client %d", clientFd);
                     break;
                 }
 
                 case static_cast<uint16_t>(PacketType::C2S_RequestOnlineList): {
                     C2S_RequestOnlineList req = C2S_RequestOnlineList::from_payload(buf);
                     auto task = std::make_shared<RequestOnlineListTask>(clientFd, req);
-                    taskQueue->push(task);
+                    dispatchTask(task, packet);
                     break;
                 }
 
                 case static_cast<uint16_t>(PacketType::C2S_SendInvite): {
                     C2S_SendInvite req = C2S_SendInvite::from_payload(buf);
                     auto task = std::make_shared<SendInviteTask>(clientFd, req);
-                    taskQueue->push(task);
+                    dispatchTask(task, packet);
                     break;
                 }
 
                 case static_cast<uint16_t>(PacketType::C2S_RespondInvite): {
                     C2S_RespondInvite req = C2S_RespondInvite::from_payload(buf);
                     auto task = std::make_shared<RespondInviteTask>(clientFd, req);
-                    taskQueue->push(task);
+                    dispatchTask(task, packet);
                     break;
                 }
 
                 case static_cast<uint16_t>(PacketType::C2S_SetReady): {
                     C2S_SetReady req = C2S_SetReady::from_payload(buf);
                     auto task = std::make_shared<SetReadyTask>(clientFd, req);
-                    taskQueue->push(task);
+                    dispatchTask(task, packet);
                     break;
                 }
 
                 case static_cast<uint16_t>(PacketType::C2S_StartGame): {
                     C2S_StartGame req = C2S_StartGame::from_payload(buf);
                     auto task = std::make_shared<StartGameTask>(clientFd, req);
-                    taskQueue->push(task);
+                    dispatchTask(task, packet);
                     break;
                 }
 
                 case static_cast<uint16_t>(PacketType::C2S_KickPlayer): {
                     C2S_KickPlayer req = C2S_KickPlayer::from_payload(buf);
                     auto task = std::make_shared<KickPlayerTask>(clientFd, req);
-                    taskQueue->push(task);
+                    dispatchTask(task, packet);
                     break;
                 }
 
                 case static_cast<uint16_t>(PacketType::C2S_GuessChar): {
                     C2S_GuessChar req = C2S_GuessChar::from_payload(buf);
                     auto task = std::make_shared<GuessCharTask>(clientFd, req);
-                    taskQueue->push(task);
+                    dispatchTask(task, packet);
                     break;
                 }
 
                 case static_cast<uint16_t>(PacketType::C2S_GuessWord): {
                     C2S_GuessWord req = C2S_GuessWord::from_payload(buf);
                     auto task = std::make_shared<GuessWordTask>(clientFd, req);
-                    taskQueue->push(task);
+                    dispatchTask(task, packet);
                     break;
                 }
 
                 case static_cast<uint16_t>(PacketType::C2S_RequestDraw): {
                     C2S_RequestDraw req = C2S_RequestDraw::from_payload(buf);
                     auto task = std::make_shared<RequestDrawTask>(clientFd, req);
-                    taskQueue->push(task);
+                    dispatchTask(task, packet);
                     break;
                 }
 
                 case static_cast<uint16_t>(PacketType::C2S_EndGame): {
                     C2S_EndGame req = C2S_EndGame::from_payload(buf);
                     auto task = std::make_shared<EndGameTask>(clientFd, req);
-                    taskQueue->push(task);
+                    dispatchTask(task, packet);
                     break;
                 }
 
                 case static_cast<uint16_t>(PacketType::C2S_RequestHistory): {
                     C2S_RequestHistory req = C2S_RequestHistory::from_payload(buf);
                     auto task = std::make_shared<RequestHistoryTask>(clientFd, req);
-                    taskQueue->push(task);
+                    dispatchTask(task, packet);
                     break;
                 }
 
                 case static_cast<uint16_t>(PacketType::C2S_RequestLeaderboard): {
                     C2S_RequestLeaderboard req = C2S_RequestLeaderboard::from_payload(buf);
                     auto task = std::make_shared<RequestLeaderboardTask>(clientFd, req);
-                    taskQueue->push(task);
+                    dispatchTask(task, packet);
                     break;
                 }
 
                 default:
-                    std::cerr << "Unknown packet type: 0x" << std::hex << packetType << std::dec << std::endl;
+                    LOG_WARN("Unknown packet type: 0x%04x", (unsigned)packet.type);
                     break;
             }
         }
         catch (const std::exception &e)
         {
-            std::cerr << "Error processing packet: " << e.what() << std::endl;
+            LOG_ERROR("Error processing packet: %s", e.what());
+        }
+    }
+    // Token buckets per peer address (login + register) and per username
+    // (login). Runs before any task is allocated so a flood costs one decode.
+    bool Server::allowAuthRequest(int clientFd, const std::string *username)
+    {
+        Connection *conn = getConnection(clientFd);
+        if (!conn)
+        {
+            return false;
+        }
+        uint64_t now = Metrics::nowNs();
+        uint32_t addr = conn->getPeerAddress();
+        bool loopback = (ntohl(addr) >> 24) == 127;
+        bool allowed = (loopback && !config.limitLoopback) || authAddressLimiter.allow(addr, now);
+        if (allowed && username)
+        {
+            allowed = loginUserLimiter.allow(*username, now);
+        }
+        if (!allowed)
+        {
+            Metrics::getInstance().increment(MetricCounter::RATE_LIMITED);
+            LOG_DEBUG("Rate limited auth request from client %d", clientFd);
+        }
+        return allowed;
+    }
+
+    Connection *Server::getTaskConnection(const Task &task) const
+    {
+        Connection *conn = getConnection(task.getClientFd());
+        return (conn && conn->id() == task.connectionId) ? conn : nullptr;
+    }
+
+    // Run cheap tasks inline (no queue hop, no eventfd), queue the rest for the worker pool
+    void Server::dispatchTask(const TaskPtr &task, const PacketView &request)
+    {
+        task->requestVersion = request.version;
+        task->requestId = request.requestId;
+        Connection *conn = getConnection(task->getClientFd());
+        task->connectionId = conn ? conn->id() : 0;
+        if (conn && conn->hasSession())
+        {
+            task->boundUser = conn->getSessionUser();
+            task->boundToken = conn->getSessionToken();
+        }
+        if (task->usesAuthPool())
+        {
+            // Bounded: shed logins instead of letting them queue without limit
+            if (authQueue->size() >= config.authQueueLimit)
+            {
+                Metrics::getInstance().increment(MetricCounter::AUTH_REJECTED);
+                task->rejectBusy();
+                deliverTaskResult(*task);
+                return;
+            }
+            if (conn)
+            {
+                conn->taskQueued();
+            }
+            authQueue->push(task);
+            return;
+        }
+
+        // v1 replies must keep request order, so inline waits for queued
+        // tasks; v2 replies carry their request id and may overtake them
+        bool mustQueue = conn && conn->getTasksInFlight() > 0 && request.version < PROTOCOL_VERSION_V2;
+        if (!task->isNonBlocking() || mustQueue)
+        {
+            if (conn)
+            {
+                conn->taskQueued();
+            }
+            taskQueue->push(task);
+            return;
+        }
+
+        uint64_t start = Metrics::nowNs();
+        try
+        {
+            task->execute();
+            Metrics::getInstance().record(MetricStage::EXECUTE, task->getPacketType(), Metrics::nowNs() - start);
+        }
+        catch (const std::exception &e)
+        {
+            LOG_ERROR("Error executing task 0x%04x: %s", (unsigned)task->getPacketType(), e.what());
+            task->failed = true;
         }
+        deliverTaskResult(*task);
     }
+
     // Send response được sử dụng bổi eventloop dưới sự hướng dẫn của workerthread
-    void Server::sendResponse(int clientFd, const std::vector<uint8_t> &packet)
+    void Server::sendResponse(int clientFd, const std::vector<uint8_t> &packet, uint8_t version, uint32_t requestId)
+    {
+        sendPacket(clientFd, packet, nullptr, version, requestId);
+    }
+
+    void Server::broadcast(const Broadcast &notification)
+    {
+        for (int targetFd : notification.targets)
+        {
+            sendPacket(targetFd, *notification.packet, &notification.packet);
+            LOG_DEBUG("Broadcasted to client %d", targetFd);
+        }
+    }
+
+    // Shared packets are queued by reference, others are copied into the send queue
+    void Server::sendPacket(int clientFd, const std::vector<uint8_t> &packet, const SharedPacket *shared, uint8_t version,
+                            uint32_t requestId)
     {
-        auto it = connections.find(clientFd);
-        if (it == connections.end())
+        // Client away: hold the packet for its resume, oldest dropped first
+        if (AuthService::isDetachedFd(clientFd))
         {
+            auto it = detachedSessions.find(clientFd);
+            if (it == detachedSessions.end())
+            {
+                return;
+            }
+            std::deque<SharedPacket> &outbox = it->second.outbox;
+            outbox.push_back(shared ? *shared : makeSharedPacket(packet));
+            if (outbox.size() > config.resumeOutboxLimit)
+            {
+                outbox.pop_front();
+                Metrics::getInstance().increment(MetricCounter::OUTBOX_DROPPED);
+            }
             return;
         }
 
+        Connection *conn = getConnection(clientFd);
+        if (!conn)
+        {
+            return;
+        }
+
+        Metrics &metrics = Metrics::getInstance();
+        uint64_t start = Metrics::nowNs();
+        // Outgoing packet type from the header (u8 version, u16 type)
+        uint16_t packetType = packet.size() >= 3 ? (uint16_t)((packet[1] << 8) | packet[2]) : 0;
+
         try
         {
             // Cố  gắng gửi dữ liệu ngay lập tức
-            // Nếu không thể gửi hết, dữ liệu sẽ được lưu vào bộ đệm gửi của Connection
-            it->second->sendData(packet.data(), packet.size());
+            // Nếu không thể gửi hết, dữ liệu sẽ được xếp hàng trong send queue của Connection
+            // Packets are encoded with a v1 header; v2 gets its own header
+            // in front of the same payload (shared payloads stay uncopied)
+            size_t wireBytes = packet.size();
+            if ((version ? version : conn->getProtocolVersion()) == PROTOCOL_VERSION_V2 &&
+                packet.size() >= PacketHeader::HEADER_SIZE)
+            {
+                uint8_t header[PacketHeader::HEADER_SIZE_V2];
+                size_t payloadLen = packet.size() - PacketHeader::HEADER_SIZE;
+                PacketHeader::write_header_v2(header, packetType, (uint32_t)payloadLen, requestId);
+                conn->sendFramed(header, sizeof(header), packet.data() + PacketHeader::HEADER_SIZE, payloadLen, shared);
+                wireBytes += PacketHeader::HEADER_SIZE_V2 - PacketHeader::HEADER_SIZE;
+            }
+            else if (shared)
+            {
+                conn->sendShared(*shared);
+            }
+            else
+            {
+                conn->sendData(packet.data(), packet.size());
+            }
 
-            // Kiểm tra liệu còn dữ liệu chưa gửi không (pendingData)
-            // Nếu còn ==> đăng ký sự kiện EPOLLOUT với eventloop.
-            size_t pendingLen;
-            if (it->second->getPendingSendData(pendingLen) != nullptr && pendingLen > 0)
+            // Backpressure: a client that does not read its responses
+            // is paused first, then dropped before it can exhaust memory
+            size_t pending = conn->pendingSendBytes();
+            if (pending > config.sendLimits.hardLimit)
             {
-                // Update event to include EPOLLOUT
-                eventLoop->addFd(clientFd, [this, clientFd]()
-                                 { handleClientWrite(clientFd); });
+                LOG_WARN("Dropping slow client fd=%d (%zu bytes queued)", clientFd, pending);
+                metrics.increment(MetricCounter::SLOW_CLIENT_DROPS);
+                closeConnection(clientFd);
+                return;
+            }
+            if (pending > config.sendLimits.highWatermark)
+            {
+                conn->setReadPaused(true);
             }
+
+            // Nếu còn dữ liệu chưa gửi ==> đăng ký sự kiện EPOLLOUT với eventloop.
+            updateInterest(*conn);
+
+            metrics.increment(MetricCounter::PACKETS_OUT);
+            metrics.increment(MetricCounter::BYTES_OUT, wireBytes);
+            metrics.record(MetricStage::SEND, packetType, Metrics::nowNs() - start);
         }
         catch (const std::exception &e)
         {
-            std::cerr << "Error sending response: " << e.what() << std::endl;
+            LOG_ERROR("Error sending response: %s", e.what());
+            closeConnection(clientFd);
         }
     }
 
-    void Server::workerThreadLoop()
+    void Server::deliverTaskResult(const Task &task)
     {
-        std::cout << "Worker thread started" << std::endl;
+        // 1. Send response to requester, unless it has gone (its fd may
+        // belong to another client by now)
+        int clientFd = task.getClientFd();
+        Connection *requester = getTaskConnection(task);
+        if (task.failed)
+        {
+            if (requester)
+            {
+                S2C_Error error;
+                error.for_type = task.getPacketType();
+                error.message = "Internal server error";
+                sendResponse(clientFd, error.to_bytes(), task.requestVersion, task.requestId);
+            }
+            return;
+        }
+        std::vector<uint8_t> packet = requester ? task.getResponsePacket() : std::vector<uint8_t>();
+
+        if (!packet.empty()) {
+            sendResponse(clientFd, packet, task.requestVersion, task.requestId);
+            LOG_DEBUG("Sent response to client %d", clientFd);
+        }
+
+        // 2. Send notifications (if any), each encoded once for all targets
+        for (const Broadcast &notification : task.getBroadcasts()) {
+            broadcast(notification);
+        }
+
+        // 3. Login/resume binds the session to the connection, logout releases it
+        const SessionBinding *binding = task.getSessionBinding();
+        if (binding && !requester && !binding->username.empty()) {
+            // Logged in (or resumed) on a connection that closed meanwhile:
+            // the session must not stay on an fd another client may get
+            detachSession(binding->clientFd, binding->username, binding->token);
+        } else if (binding && requester && binding->clientFd == clientFd) {
+            Connection *conn = requester;
+            if (conn && !binding->username.empty()) {
+                conn->bindSession(binding->username, binding->token);
+            } else if (conn && conn->getSessionToken() == binding->token) {
+                conn->releaseSession();
+            }
+
+            // Resume: replay the outbox, or take the session from a
+            // connection the server has not seen drop yet
+            if (!binding->username.empty() && binding->previousFd != binding->clientFd) {
+                if (AuthService::isDetachedFd(binding->previousFd)) {
+                    replayOutbox(binding->previousFd, binding->clientFd);
+                } else if (Connection *old = getConnection(binding->previousFd)) {
+                    if (old->getSessionToken() == binding->token) {
+                        old->releaseSession();
+                    }
+                }
+            }
+        }
+    }
+
+    void Server::workerThreadLoop(TaskQueue &queue)
+    {
+        LOG_INFO("Worker thread started");
+
+        Metrics &metrics = Metrics::getInstance();
+        size_t batchSize = config.workerBatchSize > 0 ? config.workerBatchSize : 1;
+        std::vector<TaskPtr> batch;
+        batch.reserve(batchSize);
 
         while (true)
         {
-            TaskPtr task = taskQueue->pop(); // Wait for a task ==> Do not regiester event with eventloop
-            if (!task)
+            // Wait for a ready actor, then take its queued tasks (up to batchSize) in one lock
+            if (queue.popBatch(batch, batchSize) == 0)
             {
                 break; // Queue stopped
             }
+            uint64_t actorKey = batch.front()->getActorKey();
 
-            try
+            std::vector<TaskPtr> done;
+            done.reserve(batch.size());
+            for (TaskPtr &task : batch)
             {
-                task->execute();
+                uint16_t packetType = task->getPacketType();
+                uint64_t start = Metrics::nowNs();
+                metrics.record(MetricStage::QUEUE_WAIT, packetType, start - task->enqueuedAt);
 
-                // Create callback to send response back to client
-                auto callback = std::make_shared<FunctionCallback>(
-                    [task, this]()
-                    {
-                        // 1. Send response to requester
-                        int clientFd = task->getClientFd();
-                        std::vector<uint8_t> packet = task->getResponsePacket();
-                        
-                        if (!packet.empty()) {
-                            sendResponse(clientFd, packet);
-                            std::cout << "Sent response to client " << clientFd << std::endl;
-                        }
+                try
+                {
+                    task->execute();
+                    metrics.record(MetricStage::EXECUTE, packetType, Metrics::nowNs() - start);
+                }
+                catch (const std::exception &e)
+                {
+                    LOG_ERROR("Error executing task 0x%04x: %s", (unsigned)packetType, e.what());
+                    task->failed = true;
+                }
+                // Failed tasks are delivered too: the requester gets an error
+                // and its in-flight count is released
+                done.push_back(std::move(task));
+            }
+            batch.clear();
 
-                        // 2. Send broadcast packets (if any)
-                        auto broadcasts = task->getBroadcastPackets();
-                        for (const auto& p : broadcasts) {
-                            int targetFd = p.first;
-                            const auto& data = p.second;
-                            sendResponse(targetFd, data);
-                            std::cout << "Broadcasted to client " << targetFd << std::endl;
-                        }
-                    });
+            // Let another worker pick up this actor's next tasks
+            queue.done(actorKey);
 
-                // Push callback to network thread
-                callbackQueue->push(callback);
-            }
-            catch (const std::exception &e)
+            // One callback for the whole batch: responses go out in task order
+            if (!done.empty())
             {
-                std::cerr << "Error executing task: " << e.what() << std::endl;
+                callbackQueue->push(std::make_shared<TaskBatchCallback>(
+                    std::move(done), [this](const Task &task)
+                    {
+                        if (Connection *conn = getTaskConnection(task))
+                        {
+                            conn->taskDelivered();
+                        }
+                        deliverTaskResult(task);
+                    }));
             }
         }
 
-        std::cout << "Worker thread stopped" << std::endl;
+        LOG_INFO("Worker thread stopped");
     }
 
 } // namespace hangman
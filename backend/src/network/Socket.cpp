@@ -2,14 +2,16 @@
 #include "network/Socket.h"
 #include <sys/socket.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <stdexcept>
 #include <cstring>
+#include <cerrno>
 
-int Socket::createListeningSocket(int port) {
-    // Create socket
-    int fd = socket(AF_INET, SOCK_STREAM, 0);
+int Socket::createListeningSocket(int port, bool loopbackOnly) {
+    // Create socket (non-blocking from the start)
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
     if (fd < 0) {
         throw std::runtime_error("Failed to create socket");
     }
@@ -21,7 +23,7 @@ int Socket::createListeningSocket(int port) {
     sockaddr_in addr;
     std::memset(&addr, 0, sizeof(addr));
     addr.sin_family = AF_INET;
-    addr.sin_addr.s_addr = INADDR_ANY;
+    addr.sin_addr.s_addr = htonl(loopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
     addr.sin_port = htons(port);
     
     if (bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0) {
@@ -35,9 +37,6 @@ int Socket::createListeningSocket(int port) {
         throw std::runtime_error("Failed to listen");
     }
     
-    // Set non-blocking
-    setNonBlocking(fd);
-    
     return fd;
 }
 
@@ -57,15 +56,37 @@ void Socket::setReuseAddr(int fd) {
     setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
 }
 
-int Socket::acceptConnection(int listenFd) {
+void Socket::setNoDelay(int fd) {
+    int opt = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+}
+
+void Socket::setBufferSizes(int fd, int sendBytes, int recvBytes) {
+    if (sendBytes > 0) {
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sendBytes, sizeof(sendBytes));
+    }
+    if (recvBytes > 0) {
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &recvBytes, sizeof(recvBytes));
+    }
+}
+
+void Socket::setDeferAccept(int listenFd, int seconds) {
+    // Only wake accept() once the client has actually sent data
+    setsockopt(listenFd, IPPROTO_TCP, TCP_DEFER_ACCEPT, &seconds, sizeof(seconds));
+}
+
+int Socket::acceptConnection(int listenFd, sockaddr_in* peerAddr) {
     sockaddr_in clientAddr;
     socklen_t addrLen = sizeof(clientAddr);
-    
-    int clientFd = accept(listenFd, (sockaddr*)&clientAddr, &addrLen);
-    if (clientFd >= 0) {
-        setNonBlocking(clientFd);
+
+    int clientFd;
+    do {
+        clientFd = accept4(listenFd, (sockaddr*)&clientAddr, &addrLen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    } while (clientFd < 0 && errno == EINTR);
+
+    if (clientFd >= 0 && peerAddr) {
+        *peerAddr = clientAddr;
     }
-    
     return clientFd;
 }
 
@@ -1,17 +1,45 @@
 #include "service/AuthService.h"
+#include "util/PasswordHash.h"
+#include "util/Logger.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
 #include <fstream>
 #include <sstream>
 #include <ctime>
-#include <random>
 #include <iomanip>
+#include <stdexcept>
+#include <unistd.h>
 
 namespace hangman {
 
+// Token fields are little-endian regardless of host byte order
+static void writeU32(char* out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out[i] = (char)(v >> (8 * i));
+}
+
+static void writeU64(char* out, uint64_t v) {
+    for (int i = 0; i < 8; ++i) out[i] = (char)(v >> (8 * i));
+}
+
+static uint32_t readU32(const char* in) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; ++i) v |= (uint32_t)(uint8_t)in[i] << (8 * i);
+    return v;
+}
+
+static uint64_t readU64(const char* in) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v |= (uint64_t)(uint8_t)in[i] << (8 * i);
+    return v;
+}
+
 // Singleton instance
 static AuthService* g_authService = nullptr;
 
 // Constructor
-AuthService::AuthService() {}
+AuthService::AuthService()
+    : hashIterations(PasswordHash::DEFAULT_ITERATIONS) {}
 
 // Đảm bảo chỉ có 1 đối tượng được khởi tạo (Singleton)
 AuthService& AuthService::getInstance() {
@@ -64,6 +92,7 @@ bool AuthService::loadDatabase(const std::string& dbPath) {
     }
 
     file.close();
+    statsVersion.fetch_add(1, std::memory_order_release);
     return true;
 }
 
@@ -83,11 +112,23 @@ S2C_RegisterResult AuthService::registerUser(const C2S_Register& request) {
         return result;
     }
 
-    // Lock for entire operation to prevent race conditions
+    // Cheap check first so a duplicate name does not pay for the hash
+    {
+        std::lock_guard<std::mutex> lock(usersMutex);
+        if (userExists(request.username)) {
+            result.code = ResultCode::ALREADY;
+            result.message = "Username already exists";
+            return result;
+        }
+    }
+
+    // Hash outside the lock: the KDF is the expensive part
+    std::string passwordHash = hashPassword(request.password);
+
     {
         std::lock_guard<std::mutex> lock(usersMutex);
         
-        // Check if user already exists
+        // Check again: the same name may have been registered meanwhile
         if (userExists(request.username)) {
             result.code = ResultCode::ALREADY;
             result.message = "Username already exists";
@@ -97,17 +138,19 @@ S2C_RegisterResult AuthService::registerUser(const C2S_Register& request) {
         // Add to in-memory database first
         User user;
         user.username = request.username;
-        user.passwordHash = hashPassword(request.password);
+        user.passwordHash = passwordHash;
         user.wins = 0;
         user.total_points = 0;
         users[request.username] = user;
+        statsVersion.fetch_add(1, std::memory_order_release);
     }
 
     // Save to database file (outside the lock to avoid blocking other operations)
-    if (!saveUserToDatabase(request.username, request.password)) {
+    if (!saveUserToDatabase(request.username, passwordHash)) {
         // If save fails, we need to remove from in-memory map
         std::lock_guard<std::mutex> lock(usersMutex);
         users.erase(request.username);
+        statsVersion.fetch_add(1, std::memory_order_release);
         result.code = ResultCode::SERVER_ERROR;
         result.message = "Failed to save user to database";
         return result;
@@ -128,46 +171,68 @@ S2C_LoginResult AuthService::login(const C2S_Login& request, int clientFd) {
         return result;
     }
 
-    // Verify credentials
-    bool credentialsValid = false;
+    // Copy the user record, then verify outside usersMutex (the KDF would
+    // otherwise hold up every other login and stats update)
     User user;
+    bool known;
     {
         std::lock_guard<std::mutex> lock(usersMutex);
-        if (!userExists(request.username)) {
-            result.code = ResultCode::AUTH_FAIL;
-            result.message = "Invalid username or password";
-            return result;
-        }
-
-        if (!verifyPassword(request.username, request.password)) {
-            result.code = ResultCode::AUTH_FAIL;
-            result.message = "Invalid username or password";
-            return result;
+        auto it = users.find(request.username);
+        known = it != users.end();
+        if (known) {
+            user = it->second;
         }
-
-        user = users[request.username];
-        credentialsValid = true;
     }
 
-    if (!credentialsValid) {
+    // Unknown usernames still pay for a full verify: answering them early
+    // would tell which accounts exist
+    bool needsUpgrade = false;
+    bool verified = false;
+    if (known) {
+        verified = verifyPassword(request.password, user.passwordHash, needsUpgrade);
+    } else {
+        verifyPassword(request.password, dummyHash(), needsUpgrade);
+    }
+    if (!verified) {
         result.code = ResultCode::AUTH_FAIL;
         result.message = "Invalid username or password";
         return result;
     }
 
-    // Generate session token
-    std::string token = generateSessionToken(request.username);
+    // Legacy plaintext entry: replace it with a hash now that we know the
+    // password. The file is rewritten by the next flushUsers(), so a wave of
+    // legacy logins costs one rewrite, not one each.
+    if (needsUpgrade) {
+        std::string upgraded = hashPassword(request.password);
+        std::lock_guard<std::mutex> lock(usersMutex);
+        auto it = users.find(request.username);
+        if (it != users.end() && it->second.passwordHash == user.passwordHash) {
+            it->second.passwordHash = upgraded;
+            usersDirty.store(true, std::memory_order_relaxed);
+        }
+    }
 
-    // Create session
+    // Create session and its token
+    std::string token(SESSION_TOKEN_SIZE, '\0');
+    uint64_t secret;
+    PasswordHash::randomBytes((uint8_t*)&secret, sizeof(secret));
     {
         std::lock_guard<std::mutex> lock(sessionsMutex);
-        Session session;
-        session.username = request.username;
-        session.wins = user.wins;
-        session.total_points = user.total_points;
-        session.createdAt = std::time(nullptr);
-        session.clientFd = clientFd;
-        sessions[token] = session;
+        uint32_t index = allocateSessionSlot();
+        SessionSlot& slot = sessionSlots[index];
+        slot.active = true;
+        slot.secret = secret;
+        slot.session.username = request.username;
+        slot.session.wins = user.wins;
+        slot.session.total_points = user.total_points;
+        slot.session.createdAt = std::time(nullptr);
+        slot.session.clientFd = clientFd;
+        userSlots[request.username] = index;
+        ++activeSessions;
+
+        writeU32(&token[0], index);
+        writeU32(&token[4], slot.generation);
+        writeU64(&token[8], slot.secret);
     }
 
     result.code = ResultCode::SUCCESS;
@@ -185,15 +250,14 @@ S2C_LogoutAck AuthService::logout(const C2S_Logout& request) {
     // Validate token
     {
         std::lock_guard<std::mutex> lock(sessionsMutex);
-        auto it = sessions.find(request.session_token);
-        if (it == sessions.end()) {
+        SessionSlot* slot = findSession(request.session_token);
+        if (!slot) {
             result.code = ResultCode::AUTH_FAIL;
             result.message = "Invalid session token";
             return result;
         }
 
-        // Remove session
-        sessions.erase(it);
+        removeSession(slot);
     }
 
     result.code = ResultCode::SUCCESS;
@@ -203,62 +267,142 @@ S2C_LogoutAck AuthService::logout(const C2S_Logout& request) {
 
 bool AuthService::validateSession(const std::string& token, std::string& outUsername) {
     std::lock_guard<std::mutex> lock(sessionsMutex);
-    auto it = sessions.find(token);
-    if (it == sessions.end()) {
+    SessionSlot* slot = findSession(token);
+    if (!slot) {
+        return false;
+    }
+    outUsername = slot->session.username;
+    return true;
+}
+
+bool AuthService::authenticate(const std::string& token, const std::string& boundUser, std::string& outUsername) {
+    if (!token.empty()) {
+        return validateSession(token, outUsername);
+    }
+    if (boundUser.empty()) {
         return false;
     }
-    outUsername = it->second.username;
+    outUsername = boundUser;
     return true;
 }
 
 bool AuthService::getSessionInfo(const std::string& token, Session& outSession) {
     std::lock_guard<std::mutex> lock(sessionsMutex);
-    auto it = sessions.find(token);
-    if (it == sessions.end()) {
+    SessionSlot* slot = findSession(token);
+    if (!slot) {
         return false;
     }
-    outSession = it->second;
+    outSession = slot->session;
     return true;
 }
 
-// Private helper methods
+int AuthService::detachSession(const std::string& token, int clientFd) {
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+    SessionSlot* slot = findSession(token);
+    if (!slot || slot->session.clientFd != clientFd) {
+        return -1;
+    }
+    slot->session.clientFd = detachedFd((uint32_t)(slot - sessionSlots.data()));
+    return slot->session.clientFd;
+}
 
-bool AuthService::userExists(const std::string& username) {
-    // Note: Call this with usersMutex already locked
-    return users.find(username) != users.end();
+bool AuthService::resumeSession(const std::string& token, int clientFd, Session& outSession, int& previousFd) {
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+    SessionSlot* slot = findSession(token);
+    if (!slot) {
+        return false;
+    }
+    previousFd = slot->session.clientFd;
+    slot->session.clientFd = clientFd;
+    outSession = slot->session;
+    return true;
 }
 
-bool AuthService::verifyPassword(const std::string& username, const std::string& password) {
-    // Note: Call this with usersMutex already locked
-    auto it = users.find(username);
-    if (it == users.end()) {
+std::vector<std::string> AuthService::getDetachedTokens() {
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+    std::vector<std::string> result;
+    for (uint32_t i = 0; i < sessionSlots.size(); ++i) {
+        const SessionSlot& slot = sessionSlots[i];
+        if (slot.active && isDetachedFd(slot.session.clientFd)) {
+            std::string token(SESSION_TOKEN_SIZE, '\0');
+            writeU32(&token[0], i);
+            writeU32(&token[4], slot.generation);
+            writeU64(&token[8], slot.secret);
+            result.push_back(token);
+        }
+    }
+    return result;
+}
+
+bool AuthService::expireSession(const std::string& token, int detachedFd) {
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+    SessionSlot* slot = findSession(token);
+    if (!slot || slot->session.clientFd != detachedFd) {
         return false;
     }
-    return it->second.passwordHash == hashPassword(password);
+    removeSession(slot);
+    return true;
 }
 
-void AuthService::addUser(const std::string& username, const std::string& password) {
-    // Note: Call this with usersMutex already locked
-    User user;
-    user.username = username;
-    user.passwordHash = hashPassword(password);
-    user.wins = 0;
-    user.total_points = 0;
-    users[username] = user;
+void AuthService::removeSession(SessionSlot* slot) {
+    // Note: Call this with sessionsMutex already locked
+    // New generation invalidates the token, slot is reused
+    uint32_t index = (uint32_t)(slot - sessionSlots.data());
+    auto userIt = userSlots.find(slot->session.username);
+    if (userIt != userSlots.end() && userIt->second == index) {
+        userSlots.erase(userIt);
+    }
+    slot->active = false;
+    slot->generation++;
+    slot->session = Session();
+    freeSlots.push_back(index);
+    --activeSessions;
+}
+
+AuthService::SessionSlot* AuthService::findSession(const std::string& token) {
+    // Note: Call this with sessionsMutex already locked
+    if (token.size() != SESSION_TOKEN_SIZE) {
+        return nullptr;
+    }
+    uint32_t index = readU32(&token[0]);
+    if (index >= sessionSlots.size()) {
+        return nullptr;
+    }
+    SessionSlot& slot = sessionSlots[index];
+    // Generation and secret are checked together so timing does not reveal which part was wrong
+    uint64_t diff = (uint64_t)(readU32(&token[4]) ^ slot.generation) | (readU64(&token[8]) ^ slot.secret);
+    if (!slot.active || diff != 0) {
+        return nullptr;
+    }
+    return &slot;
+}
+
+uint32_t AuthService::allocateSessionSlot() {
+    // Note: Call this with sessionsMutex already locked
+    if (!freeSlots.empty()) {
+        uint32_t index = freeSlots.back();
+        freeSlots.pop_back();
+        return index;
+    }
+    sessionSlots.emplace_back();
+    return (uint32_t)(sessionSlots.size() - 1);
 }
 
-std::string AuthService::generateSessionToken(const std::string& username) {
-    // Simple token generation: username + timestamp + random number
-    static std::random_device rd;
-    static std::mt19937 gen(rd());
-    static std::uniform_int_distribution<> dis(0, 999999);
+// Private helper methods
+
+bool AuthService::userExists(const std::string& username) {
+    // Note: Call this with usersMutex already locked
+    return users.find(username) != users.end();
+}
 
-    std::ostringstream oss;
-    oss << username << "_" << std::time(nullptr) << "_" << dis(gen);
-    return oss.str();
+bool AuthService::verifyPassword(const std::string& password, const std::string& storedHash, bool& needsUpgrade) {
+    // No lock needed: works on a copy of the stored hash
+    return PasswordHash::verify(password, storedHash, needsUpgrade);
 }
 
-bool AuthService::saveUserToDatabase(const std::string& username, const std::string& password) {
+bool AuthService::saveUserToDatabase(const std::string& username, const std::string& passwordHash) {
+    // Not while a rewrite is replacing the file: the line would go to the old one
+    std::lock_guard<std::mutex> fileLock(usersFileMutex);
     try {
         std::ofstream file(dbPath, std::ios::app);
         if (!file.is_open()) {
@@ -266,7 +410,6 @@ bool AuthService::saveUserToDatabase(const std::string& username, const std::str
         }
 
         // Format: username:passwordHash:wins:points
-        std::string passwordHash = hashPassword(password);
         file << username << ":" << passwordHash << ":0:0\n";
         file.close();
         return true;
@@ -276,39 +419,152 @@ bool AuthService::saveUserToDatabase(const std::string& username, const std::str
 }
 
 std::string AuthService::hashPassword(const std::string& password) {
-    // Simple hash: just return the password as-is for now
-    // TODO: In production, use bcrypt or similar
-    // For now, we use a simple approach to keep it simple
-    return password;
+    // Salted PBKDF2-HMAC-SHA256, cost set by setHashIterations()
+    return PasswordHash::hash(password, hashIterations.load(std::memory_order_relaxed));
+}
+
+const std::string& AuthService::dummyHash() {
+    // Per thread, so no lock; rebuilt when the cost changes
+    static thread_local std::string hash;
+    static thread_local uint32_t iterations = 0;
+    uint32_t current = hashIterations.load(std::memory_order_relaxed);
+    if (hash.empty() || iterations != current) {
+        hash = PasswordHash::hash("", current);
+        iterations = current;
+    }
+    return hash;
+}
+
+void AuthService::saveState(ByteBuffer& out) {
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+    // Every slot, so generations (and thus live tokens) survive the restart
+    out.write_u32((uint32_t)sessionSlots.size());
+    for (const SessionSlot& slot : sessionSlots) {
+        out.write_u32(slot.generation);
+        out.write_u8(slot.active ? 1 : 0);
+        if (!slot.active) {
+            continue;
+        }
+        out.write_u64(slot.secret);
+        out.write_string(slot.session.username);
+        out.write_u32(slot.session.wins);
+        out.write_u32(slot.session.total_points);
+        out.write_u64(slot.session.createdAt);
+    }
+}
+
+std::function<void()> AuthService::parseState(ByteBuffer& in) {
+    // Every slot takes at least 5 bytes (generation + active flag): a count
+    // the rest of the file cannot hold is corrupt, not an allocation size
+    uint32_t count = in.read_u32();
+    if (count > (in.size() - in.rpos) / 5) {
+        throw std::runtime_error("session count exceeds snapshot size");
+    }
+    std::vector<SessionSlot> slots(count);
+    for (SessionSlot& slot : slots) {
+        slot.generation = in.read_u32();
+        slot.active = in.read_u8() != 0;
+        if (!slot.active) {
+            continue;
+        }
+        slot.secret = in.read_u64();
+        slot.session.username = in.read_string();
+        slot.session.wins = in.read_u32();
+        slot.session.total_points = in.read_u32();
+        slot.session.createdAt = in.read_u64();
+    }
+
+    return [this, slots = std::move(slots)]() mutable {
+        std::lock_guard<std::mutex> lock(sessionsMutex);
+        sessionSlots = std::move(slots);
+        freeSlots.clear();
+        userSlots.clear();
+        activeSessions = 0;
+        for (uint32_t i = 0; i < sessionSlots.size(); ++i) {
+            if (sessionSlots[i].active) {
+                sessionSlots[i].session.clientFd = detachedFd(i);
+                userSlots[sessionSlots[i].session.username] = i;
+                ++activeSessions;
+            } else {
+                freeSlots.push_back(i);
+            }
+        }
+    };
 }
 
 std::vector<Session> AuthService::getAllSessions() {
     std::lock_guard<std::mutex> lock(sessionsMutex);
     std::vector<Session> result;
-    for (const auto& pair : sessions) {
-        result.push_back(pair.second);
+    result.reserve(activeSessions);
+    for (const SessionSlot& slot : sessionSlots) {
+        if (slot.active) {
+            result.push_back(slot.session);
+        }
     }
     return result;
 }
 
-int AuthService::getClientFd(const std::string& username) {
+std::vector<std::string> AuthService::getOnlineUsernames() {
     std::lock_guard<std::mutex> lock(sessionsMutex);
-    for (const auto& pair : sessions) {
-        if (pair.second.username == username) {
-            return pair.second.clientFd;
+    std::vector<std::string> result;
+    result.reserve(activeSessions);
+    for (const SessionSlot& slot : sessionSlots) {
+        if (slot.active) {
+            result.push_back(slot.session.username);
         }
     }
-    return -1;
+    return result;
+}
+
+int AuthService::getClientFd(const std::string& username) {
+    std::lock_guard<std::mutex> lock(sessionsMutex);
+    auto it = userSlots.find(username);
+    if (it == userSlots.end()) {
+        return -1;
+    }
+    return sessionSlots[it->second].session.clientFd;
 }
 
 void AuthService::updateUserStats(const std::string& username, bool isWin, uint32_t points) {
-    std::lock_guard<std::mutex> lock(usersMutex);
-    auto it = users.find(username);
-    if (it != users.end()) {
+    std::lock_guard<std::mutex> fileLock(usersFileMutex);
+    std::string contents;
+    {
+        std::lock_guard<std::mutex> lock(usersMutex);
+        auto it = users.find(username);
+        if (it == users.end()) {
+            return;
+        }
         if (isWin) it->second.wins++;
         it->second.total_points += points;
-        saveAllUsersToDatabase();
+        statsVersion.fetch_add(1, std::memory_order_release);
+        contents = serializeUsers();
+        usersDirty.store(false, std::memory_order_relaxed);
+    }
+    // Disk I/O outside usersMutex: logins and registers go on meanwhile
+    if (!writeUsersFile(contents)) {
+        usersDirty.store(true, std::memory_order_relaxed);
+    }
+}
+
+bool AuthService::flushUsers() {
+    if (!usersDirty.load(std::memory_order_relaxed)) {
+        return true;
+    }
+    std::lock_guard<std::mutex> fileLock(usersFileMutex);
+    std::string contents;
+    {
+        std::lock_guard<std::mutex> lock(usersMutex);
+        if (!usersDirty.load(std::memory_order_relaxed)) {
+            return true; // Written by a stats update meanwhile
+        }
+        contents = serializeUsers();
+        usersDirty.store(false, std::memory_order_relaxed);
+    }
+    if (!writeUsersFile(contents)) {
+        usersDirty.store(true, std::memory_order_relaxed);
+        return false;
     }
+    return true;
 }
 
 std::vector<User> AuthService::getAllUsers() {
@@ -320,21 +576,49 @@ std::vector<User> AuthService::getAllUsers() {
     return result;
 }
 
-bool AuthService::saveAllUsersToDatabase() {
-    try {
-        std::ofstream file(dbPath, std::ios::trunc); // Overwrite
-        if (!file.is_open()) return false;
+std::string AuthService::serializeUsers() {
+    std::string contents;
+    contents.reserve(users.size() * 128);
+    for (const auto& pair : users) {
+        const User& u = pair.second;
+        // Format: username:passwordHash:wins:points
+        contents += u.username + ":" + u.passwordHash + ":" + std::to_string(u.wins) + ":" +
+                    std::to_string(u.total_points) + "\n";
+    }
+    return contents;
+}
 
-        for (const auto& pair : users) {
-            const User& u = pair.second;
-            // Format: username:passwordHash:wins:points
-            file << u.username << ":" << u.passwordHash << ":" << u.wins << ":" << u.total_points << "\n";
+bool AuthService::writeUsersFile(const std::string& contents) {
+    // Write next to the file, then rename: a crash leaves the old or the new
+    // file, never a truncated one. Owner-only, it holds password hashes.
+    std::string tmpPath = dbPath + ".tmp";
+    int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        LOG_ERROR("Cannot open %s: %s", tmpPath.c_str(), strerror(errno));
+        return false;
+    }
+    size_t written = 0;
+    while (written < contents.size()) {
+        ssize_t n = write(fd, contents.data() + written, contents.size() - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
         }
-        file.close();
-        return true;
-    } catch (...) {
+        if (n <= 0) {
+            LOG_ERROR("Write to %s failed: %s", tmpPath.c_str(), strerror(errno));
+            close(fd);
+            unlink(tmpPath.c_str());
+            return false;
+        }
+        written += (size_t)n;
+    }
+    bool flushed = fsync(fd) == 0;
+    flushed = close(fd) == 0 && flushed;
+    if (!flushed || rename(tmpPath.c_str(), dbPath.c_str()) != 0) {
+        LOG_ERROR("Saving %s failed: %s", dbPath.c_str(), strerror(errno));
+        unlink(tmpPath.c_str());
         return false;
     }
+    return true;
 }
 
 } // namespace hangman
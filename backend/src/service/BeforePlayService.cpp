@@ -1,7 +1,6 @@
 #include "service/BeforePlayService.h"
 #include "service/AuthService.h"
 #include "service/RoomService.h"
-#include <iostream>
 #include <algorithm>
 
 #include "service/MatchService.h"
@@ -17,34 +16,34 @@ BeforePlayService& BeforePlayService::getInstance() {
     return *g_beforePlayService;
 }
 
-S2C_OnlineList BeforePlayService::getOnlineList(const C2S_RequestOnlineList& request) {
+S2C_OnlineList BeforePlayService::getOnlineList(const C2S_RequestOnlineList& request, const std::string& boundUser) {
     S2C_OnlineList response;
     std::string username;
 
-    if (!AuthService::getInstance().validateSession(request.session_token, username)) {
+    if (!AuthService::getInstance().authenticate(request.session_token, boundUser, username)) {
         return response; // Empty list on auth fail
     }
 
-    auto sessions = AuthService::getInstance().getAllSessions();
-    for (const auto& session : sessions) {
+    auto online = AuthService::getInstance().getOnlineUsernames();
+    for (auto& name : online) {
         // Filter out self
-        if (session.username == username) continue;
+        if (name == username) continue;
 
         // Check if user is FREE (not in any room)
-        if (!RoomService::getInstance().isUserInRoom(session.username)) {
-            response.users.push_back(session.username);
+        if (!RoomService::getInstance().isUserInRoom(name)) {
+            response.users.push_back(std::move(name));
         }
     }
     return response;
 }
 
-InviteResult BeforePlayService::sendInvite(const C2S_SendInvite& request, int senderFd) {
+InviteResult BeforePlayService::sendInvite(const C2S_SendInvite& request, int senderFd, const std::string& boundUser) {
     InviteResult result;
     result.success = false;
     result.targetFd = -1;
     
     std::string senderUsername;
-    if (!AuthService::getInstance().validateSession(request.session_token, senderUsername)) {
+    if (!AuthService::getInstance().authenticate(request.session_token, boundUser, senderUsername)) {
         result.errorPacket.message = "Invalid session";
         return result;
     }
@@ -71,13 +70,13 @@ InviteResult BeforePlayService::sendInvite(const C2S_SendInvite& request, int se
     return result;
 }
 
-RespondInviteResult BeforePlayService::respondInvite(const C2S_RespondInvite& request, int targetFd) {
+RespondInviteResult BeforePlayService::respondInvite(const C2S_RespondInvite& request, int targetFd, const std::string& boundUser) {
     RespondInviteResult result;
     result.accepted = request.accept;
     result.senderFd = -1;
 
     std::string targetUsername;
-    if (!AuthService::getInstance().validateSession(request.session_token, targetUsername)) {
+    if (!AuthService::getInstance().authenticate(request.session_token, boundUser, targetUsername)) {
         return result;
     }
 
@@ -99,9 +98,8 @@ RespondInviteResult BeforePlayService::respondInvite(const C2S_RespondInvite& re
     // We need to find the room where sender is host? Or room specified in invite?
     // The invite response doesn't carry room_id, but we assume sender is in a room.
     // Let's find the room where sender is.
-    Room* room = RoomService::getInstance().getRoomByUsername(request.from_username);
-    
-    if (!room) {
+    Room room;
+    if (!RoomService::getInstance().getRoomByUsername(request.from_username, room)) {
         result.joinRoomResult.code = ResultCode::NOT_FOUND;
         result.joinRoomResult.message = "Room not found or sender left";
         
@@ -111,7 +109,7 @@ RespondInviteResult BeforePlayService::respondInvite(const C2S_RespondInvite& re
         return result;
     }
 
-    if (room->players.size() >= 2) { // Assuming max 2 players
+    if (room.players.size() >= 2) { // Assuming max 2 players
         result.joinRoomResult.code = ResultCode::FAIL;
         result.joinRoomResult.message = "Room is full";
         
@@ -121,7 +119,7 @@ RespondInviteResult BeforePlayService::respondInvite(const C2S_RespondInvite& re
     }
 
     // Add target to room
-    result.joinRoomResult = RoomService::getInstance().joinRoom(room->id, targetUsername, targetFd);
+    result.joinRoomResult = RoomService::getInstance().joinRoom(room.id, targetUsername, targetFd);
     
     if (result.joinRoomResult.code != ResultCode::SUCCESS) {
         result.responsePacket.accepted = false;
@@ -136,28 +134,28 @@ RespondInviteResult BeforePlayService::respondInvite(const C2S_RespondInvite& re
     return result;
 }
 
-SetReadyResult BeforePlayService::setReady(const C2S_SetReady& request, int clientFd) {
+SetReadyResult BeforePlayService::setReady(const C2S_SetReady& request, int clientFd, const std::string& boundUser) {
     SetReadyResult result;
     result.gameStarted = false;
     result.hostFd = -1;
     result.challengerFd = clientFd;
 
     std::string username;
-    if (!AuthService::getInstance().validateSession(request.session_token, username)) {
+    if (!AuthService::getInstance().authenticate(request.session_token, boundUser, username)) {
         result.ackPacket.code = ResultCode::AUTH_FAIL;
         result.ackPacket.message = "Invalid session";
         return result;
     }
 
-    Room* room = RoomService::getInstance().getRoom(request.room_id);
-    if (!room) {
+    Room room;
+    if (!RoomService::getInstance().getRoom(request.room_id, room)) {
         result.ackPacket.code = ResultCode::NOT_FOUND;
         result.ackPacket.message = "Room not found";
         return result;
     }
 
     // Check if game is already playing
-    if (room->state == RoomState::PLAYING) {
+    if (room.state == RoomState::PLAYING) {
         result.ackPacket.code = ResultCode::FAIL;
         result.ackPacket.message = "Game already in progress";
         return result;
@@ -172,8 +170,8 @@ SetReadyResult BeforePlayService::setReady(const C2S_SetReady& request, int clie
 
     // Notify host
     // Find host fd
-    for (const auto& p : room->players) {
-        if (p.username == room->host_username) {
+    for (const auto& p : room.players) {
+        if (p.username == room.host_username) {
             result.hostFd = p.clientFd;
             break;
         }
@@ -185,24 +183,24 @@ SetReadyResult BeforePlayService::setReady(const C2S_SetReady& request, int clie
     return result;
 }
 
-StartGameResult BeforePlayService::startGame(const C2S_StartGame& request, int hostFd) {
+StartGameResult BeforePlayService::startGame(const C2S_StartGame& request, int hostFd, const std::string& boundUser) {
     StartGameResult result;
     result.success = false;
     result.opponentFd = -1;
 
     std::string username;
-    if (!AuthService::getInstance().validateSession(request.session_token, username)) {
+    if (!AuthService::getInstance().authenticate(request.session_token, boundUser, username)) {
         result.errorPacket.message = "Invalid session";
         return result;
     }
 
-    Room* room = RoomService::getInstance().getRoom(request.room_id);
-    if (!room) {
+    Room room;
+    if (!RoomService::getInstance().getRoom(request.room_id, room)) {
         result.errorPacket.message = "Room not found";
         return result;
     }
 
-    if (room->host_username != username) {
+    if (room.host_username != username) {
         result.errorPacket.message = "Only host can start game";
         return result;
     }
@@ -210,7 +208,7 @@ StartGameResult BeforePlayService::startGame(const C2S_StartGame& request, int h
     // Check if opponent is ready
     bool opponentReady = false;
     std::string opponentName;
-    for (const auto& p : room->players) {
+    for (const auto& p : room.players) {
         if (p.username != username) {
             if (p.state == PlayerState::READY) {
                 opponentReady = true;
@@ -238,7 +236,7 @@ StartGameResult BeforePlayService::startGame(const C2S_StartGame& request, int h
     
     // Initialize Match
     std::vector<std::string> players;
-    for (const auto& p : room->players) {
+    for (const auto& p : room.players) {
         players.push_back(p.username);
     }
     MatchService::getInstance().startMatch(request.room_id, players, word);
@@ -251,32 +249,32 @@ StartGameResult BeforePlayService::startGame(const C2S_StartGame& request, int h
     return result;
 }
 
-KickResult BeforePlayService::kickPlayer(const C2S_KickPlayer& request, int hostFd) {
+KickResult BeforePlayService::kickPlayer(const C2S_KickPlayer& request, int hostFd, const std::string& boundUser) {
     KickResult result;
     result.success = false;
     result.targetFd = -1;
 
     std::string username;
-    if (!AuthService::getInstance().validateSession(request.session_token, username)) {
+    if (!AuthService::getInstance().authenticate(request.session_token, boundUser, username)) {
         result.resultPacket.code = ResultCode::AUTH_FAIL;
         result.resultPacket.message = "Invalid session";
         return result;
     }
 
-    Room* room = RoomService::getInstance().getRoom(request.room_id);
-    if (!room) {
+    Room room;
+    if (!RoomService::getInstance().getRoom(request.room_id, room)) {
         result.resultPacket.code = ResultCode::NOT_FOUND;
         result.resultPacket.message = "Room not found";
         return result;
     }
 
-    if (room->host_username != username) {
+    if (room.host_username != username) {
         result.resultPacket.code = ResultCode::FAIL;
         result.resultPacket.message = "Only host can kick";
         return result;
     }
 
-    if (room->state == RoomState::PLAYING) {
+    if (room.state == RoomState::PLAYING) {
         result.resultPacket.code = ResultCode::FAIL;
         result.resultPacket.message = "Cannot kick during game";
         return result;
@@ -284,7 +282,7 @@ KickResult BeforePlayService::kickPlayer(const C2S_KickPlayer& request, int host
 
     // Find target
     bool found = false;
-    for (const auto& p : room->players) {
+    for (const auto& p : room.players) {
         if (p.username == request.target_username) {
             result.targetFd = p.clientFd;
             found = true;
@@ -1,7 +1,7 @@
 #include "service/MatchService.h"
 #include "service/AuthService.h"
 #include "service/RoomService.h"
-#include <iostream>
+#include "util/Logger.h"
 #include <fstream>
 #include <sstream>
 #include <ctime>
@@ -18,10 +18,15 @@ MatchService& MatchService::getInstance() {
     return *g_matchService;
 }
 
-void MatchService::startMatch(uint32_t roomId, const std::vector<std::string>& players, const std::string& word) {
+MatchService::MatchEntryPtr MatchService::findMatch(uint32_t roomId) {
     std::lock_guard<std::mutex> lock(matchesMutex);
-    
-    Match match;
+    auto it = matches.find(roomId);
+    return it == matches.end() ? nullptr : it->second;
+}
+
+void MatchService::startMatch(uint32_t roomId, const std::vector<std::string>& players, const std::string& word) {
+    auto entry = std::make_shared<MatchEntry>();
+    Match& match = entry->match;
     match.matchId = roomId; // Use roomId as matchId for simplicity
     match.roomId = roomId;
     match.word = word;
@@ -34,8 +39,12 @@ void MatchService::startMatch(uint32_t roomId, const std::vector<std::string>& p
         match.playerStates[p] = state;
     }
 
-    matches[roomId] = match;
-    std::cout << "Match started for room " << roomId << " with word " << word << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(matchesMutex);
+        matches[roomId] = std::move(entry);
+    }
+    LOG_INFO("Match started for room %u", roomId);
+    LOG_DEBUG("Match %u word: %s", roomId, word.c_str());
 }
 
 std::string MatchService::getExposedPattern(const std::string& word, const std::set<char>& guessed) {
@@ -52,24 +61,28 @@ std::string MatchService::getExposedPattern(const std::string& word, const std::
     return pattern;
 }
 
-GuessCharResult MatchService::guessChar(const C2S_GuessChar& request) {
+GuessCharResult MatchService::guessChar(const C2S_GuessChar& request, const std::string& boundUser) {
     GuessCharResult result;
     result.success = false;
 
     std::string username;
-    if (!AuthService::getInstance().validateSession(request.session_token, username)) {
+    if (!AuthService::getInstance().authenticate(request.session_token, boundUser, username)) {
         result.errorPacket.message = "Invalid session";
         return result;
     }
 
-    std::lock_guard<std::mutex> lock(matchesMutex);
-    auto it = matches.find(request.room_id);
-    if (it == matches.end() || !it->second.active) {
+    MatchEntryPtr entry = findMatch(request.room_id);
+    if (!entry) {
         result.errorPacket.message = "Match not found or ended";
         return result;
     }
 
-    Match& match = it->second;
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    Match& match = entry->match;
+    if (!match.active) {
+        result.errorPacket.message = "Match not found or ended";
+        return result;
+    }
     if (match.playerStates.find(username) == match.playerStates.end()) {
         result.errorPacket.message = "Player not in match";
         return result;
@@ -120,25 +133,29 @@ GuessCharResult MatchService::guessChar(const C2S_GuessChar& request) {
     return result;
 }
 
-GuessWordResult MatchService::guessWord(const C2S_GuessWord& request) {
+GuessWordResult MatchService::guessWord(const C2S_GuessWord& request, const std::string& boundUser) {
     GuessWordResult result;
     result.success = false;
     result.gameEnded = false;
 
     std::string username;
-    if (!AuthService::getInstance().validateSession(request.session_token, username)) {
+    if (!AuthService::getInstance().authenticate(request.session_token, boundUser, username)) {
         result.errorPacket.message = "Invalid session";
         return result;
     }
 
-    std::lock_guard<std::mutex> lock(matchesMutex);
-    auto it = matches.find(request.room_id);
-    if (it == matches.end() || !it->second.active) {
+    MatchEntryPtr entry = findMatch(request.room_id);
+    if (!entry) {
         result.errorPacket.message = "Match not found";
         return result;
     }
 
-    Match& match = it->second;
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    Match& match = entry->match;
+    if (!match.active) {
+        result.errorPacket.message = "Match not found";
+        return result;
+    }
     PlayerMatchState& state = match.playerStates[username];
     
     if (state.finished) {
@@ -172,25 +189,26 @@ GuessWordResult MatchService::guessWord(const C2S_GuessWord& request) {
     return result;
 }
 
-std::pair<int, S2C_DrawRequest> MatchService::requestDraw(const C2S_RequestDraw& request) {
+std::pair<int, S2C_DrawRequest> MatchService::requestDraw(const C2S_RequestDraw& request, const std::string& boundUser) {
     std::string username;
-    if (!AuthService::getInstance().validateSession(request.session_token, username)) {
+    if (!AuthService::getInstance().authenticate(request.session_token, boundUser, username)) {
         return {-1, {}};
     }
 
-    std::lock_guard<std::mutex> lock(matchesMutex);
-    auto it = matches.find(request.room_id);
-    if (it == matches.end()) return {-1, {}};
+    MatchEntryPtr entry = findMatch(request.room_id);
+    if (!entry) return {-1, {}};
 
-    Match& match = it->second;
-    int opponentFd = -1;
-    
-    for (const auto& pair : match.playerStates) {
-        if (pair.first != username) {
-            opponentFd = AuthService::getInstance().getClientFd(pair.first);
-            break;
+    std::string opponentName;
+    {
+        std::lock_guard<std::mutex> lock(entry->mutex);
+        for (const auto& pair : entry->match.playerStates) {
+            if (pair.first != username) {
+                opponentName = pair.first;
+                break;
+            }
         }
     }
+    int opponentFd = opponentName.empty() ? -1 : AuthService::getInstance().getClientFd(opponentName);
 
     S2C_DrawRequest packet;
     packet.from_username = username;
@@ -199,35 +217,38 @@ std::pair<int, S2C_DrawRequest> MatchService::requestDraw(const C2S_RequestDraw&
     return {opponentFd, packet};
 }
 
-EndGameResult MatchService::endGame(const C2S_EndGame& request) {
+EndGameResult MatchService::endGame(const C2S_EndGame& request, const std::string& boundUser) {
     EndGameResult result;
     result.success = false;
     result.opponentFd = -1;
 
     std::string username;
-    if (!AuthService::getInstance().validateSession(request.session_token, username)) {
+    if (!AuthService::getInstance().authenticate(request.session_token, boundUser, username)) {
         result.errorPacket.message = "Invalid session";
         return result;
     }
 
-    std::lock_guard<std::mutex> lock(matchesMutex);
-    auto it = matches.find(request.room_id);
-    if (it == matches.end()) {
+    MatchEntryPtr entry = findMatch(request.room_id);
+    if (!entry) {
         result.errorPacket.message = "Match not found";
         return result;
     }
 
-    Match& match = it->second;
-    
-    // Find opponent
+    // Find opponent (match lock only for the lookup; stats and history
+    // below do file I/O and must not block the match)
     std::string opponentName;
-    for (const auto& pair : match.playerStates) {
-        if (pair.first != username) {
-            opponentName = pair.first;
-            result.opponentFd = AuthService::getInstance().getClientFd(opponentName);
-            break;
+    {
+        std::lock_guard<std::mutex> lock(entry->mutex);
+        for (const auto& pair : entry->match.playerStates) {
+            if (pair.first != username) {
+                opponentName = pair.first;
+                break;
+            }
         }
     }
+    if (!opponentName.empty()) {
+        result.opponentFd = AuthService::getInstance().getClientFd(opponentName);
+    }
 
     // Update stats and history
     // result_code: 0 = resignation, 1 = win, 2 = loss, 3 = draw
@@ -275,6 +296,76 @@ EndGameResult MatchService::endGame(const C2S_EndGame& request) {
     return result;
 }
 
+std::vector<Match> MatchService::getActiveMatches() {
+    std::vector<MatchEntryPtr> entries;
+    {
+        std::lock_guard<std::mutex> lock(matchesMutex);
+        entries.reserve(matches.size());
+        for (const auto& pair : matches) {
+            entries.push_back(pair.second);
+        }
+    }
+
+    std::vector<Match> result;
+    for (const auto& entry : entries) {
+        std::lock_guard<std::mutex> lock(entry->mutex);
+        if (entry->match.active) {
+            result.push_back(entry->match);
+        }
+    }
+    return result;
+}
+
+void MatchService::saveState(ByteBuffer& out) {
+    // Finished matches are not needed after a restart
+    std::vector<Match> active = getActiveMatches();
+    out.write_u32((uint32_t)active.size());
+    for (const Match& match : active) {
+        out.write_u32(match.matchId);
+        out.write_u32(match.roomId);
+        out.write_string(match.word);
+        out.write_u8((uint8_t)match.playerStates.size());
+        for (const auto& pair : match.playerStates) {
+            const PlayerMatchState& state = pair.second;
+            out.write_string(state.username);
+            out.write_string(std::string(state.guessedChars.begin(), state.guessedChars.end()));
+            out.write_u8(state.remainingAttempts);
+            out.write_u8((state.finished ? 1 : 0) | (state.won ? 2 : 0));
+        }
+    }
+}
+
+std::function<void()> MatchService::parseState(ByteBuffer& in) {
+    std::unordered_map<uint32_t, MatchEntryPtr> loaded;
+    uint32_t count = in.read_u32();
+    for (uint32_t i = 0; i < count; ++i) {
+        auto entry = std::make_shared<MatchEntry>();
+        Match& match = entry->match;
+        match.matchId = in.read_u32();
+        match.roomId = in.read_u32();
+        match.word = in.read_string();
+        match.active = true;
+        uint8_t players = in.read_u8();
+        for (uint8_t p = 0; p < players; ++p) {
+            PlayerMatchState state;
+            state.username = in.read_string();
+            std::string guessed = in.read_string();
+            state.guessedChars.insert(guessed.begin(), guessed.end());
+            state.remainingAttempts = in.read_u8();
+            uint8_t flags = in.read_u8();
+            state.finished = (flags & 1) != 0;
+            state.won = (flags & 2) != 0;
+            match.playerStates[state.username] = state;
+        }
+        loaded[match.roomId] = std::move(entry);
+    }
+
+    return [this, loaded = std::move(loaded)]() mutable {
+        std::lock_guard<std::mutex> lock(matchesMutex);
+        matches = std::move(loaded);
+    };
+}
+
 void MatchService::saveHistory(const std::string& username, const std::string& opponent, uint8_t result, const std::string& summary) {
     std::string dir = "database/history/" + username;
     try {
@@ -1,6 +1,6 @@
 #include "service/RoomService.h"
 #include "service/AuthService.h"
-#include <iostream>
+#include "util/Logger.h"
 
 namespace hangman {
 
@@ -15,12 +15,12 @@ RoomService& RoomService::getInstance() {
 
 RoomService::RoomService() {}
 
-S2C_CreateRoomResult RoomService::createRoom(const C2S_CreateRoom& request, int clientFd) {
+S2C_CreateRoomResult RoomService::createRoom(const C2S_CreateRoom& request, int clientFd, const std::string& boundUser) {
     S2C_CreateRoomResult result;
     std::string username;
 
     // Validate session
-    if (!AuthService::getInstance().validateSession(request.session_token, username)) {
+    if (!AuthService::getInstance().authenticate(request.session_token, boundUser, username)) {
         result.code = ResultCode::AUTH_FAIL;
         result.message = "Invalid session";
         result.room_id = 0;
@@ -49,23 +49,24 @@ S2C_CreateRoomResult RoomService::createRoom(const C2S_CreateRoom& request, int
     room.players.push_back(hostInfo);
 
     rooms[roomId] = room;
+    addMembership(username, roomId);
 
     result.code = ResultCode::SUCCESS;
     result.message = "Room created successfully";
     result.room_id = roomId;
 
-    std::cout << "Room created: " << roomId << " by " << username << std::endl;
+    LOG_INFO("Room created: %u by %s", roomId, username.c_str());
 
     return result;
 }
 
-LeaveRoomResult RoomService::leaveRoom(const C2S_LeaveRoom& request, int clientFd) {
+LeaveRoomResult RoomService::leaveRoom(const C2S_LeaveRoom& request, int clientFd, const std::string& boundUser) {
     LeaveRoomResult result;
     result.leaverFd = clientFd;
     std::string username;
 
     // Validate session
-    if (!AuthService::getInstance().validateSession(request.session_token, username)) {
+    if (!AuthService::getInstance().authenticate(request.session_token, boundUser, username)) {
         result.ackPacket.code = ResultCode::AUTH_FAIL;
         result.ackPacket.message = "Invalid session";
         return result;
@@ -87,6 +88,7 @@ LeaveRoomResult RoomService::leaveRoom(const C2S_LeaveRoom& request, int clientF
     for (auto playerIt = room.players.begin(); playerIt != room.players.end(); ++playerIt) {
         if (playerIt->username == username) {
             room.players.erase(playerIt);
+            removeMembership(username, request.room_id);
             found = true;
             break;
         }
@@ -108,7 +110,7 @@ LeaveRoomResult RoomService::leaveRoom(const C2S_LeaveRoom& request, int clientF
         if (!room.players.empty()) {
             // Assign new host
             room.host_username = room.players[0].username;
-            std::cout << "New host for room " << request.room_id << ": " << room.host_username << std::endl;
+            LOG_INFO("New host for room %u: %s", request.room_id, room.host_username.c_str());
 
             PlayerInfo& newHost = room.players[0];
             
@@ -121,7 +123,7 @@ LeaveRoomResult RoomService::leaveRoom(const C2S_LeaveRoom& request, int clientF
         } else {
             // Room empty, delete it
             rooms.erase(it);
-            std::cout << "Room deleted: " << request.room_id << std::endl;
+            LOG_INFO("Room deleted: %u", request.room_id);
         }
     } else {
         // 1. Send to leaver (guest)
@@ -143,42 +145,60 @@ LeaveRoomResult RoomService::leaveRoom(const C2S_LeaveRoom& request, int clientF
         }
     }
 
-    std::cout << "User " << username << " left room " << request.room_id << std::endl;
+    LOG_INFO("User %s left room %u", username.c_str(), request.room_id);
 
     return result;
 }
 
 bool RoomService::isUserInRoom(const std::string& username) {
     std::lock_guard<std::mutex> lock(roomsMutex);
-    for (const auto& pair : rooms) {
-        for (const auto& player : pair.second.players) {
-            if (player.username == username) {
-                return true;
-            }
+    return roomMembership.count(username) > 0;
+}
+
+void RoomService::addMembership(const std::string& username, uint32_t roomId) {
+    roomMembership[username].push_back(roomId);
+}
+
+void RoomService::removeMembership(const std::string& username, uint32_t roomId) {
+    auto it = roomMembership.find(username);
+    if (it == roomMembership.end()) {
+        return;
+    }
+    std::vector<uint32_t>& joined = it->second;
+    for (size_t i = 0; i < joined.size(); ++i) {
+        if (joined[i] == roomId) {
+            joined[i] = joined.back();
+            joined.pop_back();
+            break;
         }
     }
-    return false;
+    if (joined.empty()) {
+        roomMembership.erase(it);
+    }
 }
 
-Room* RoomService::getRoom(uint32_t roomId) {
-    // WARNING: Not thread safe if used without lock. 
-    // Should only be used if caller guarantees safety or for read-only where race is acceptable.
-    // Better to use specific methods.
+bool RoomService::getRoom(uint32_t roomId, Room& out) {
+    std::lock_guard<std::mutex> lock(roomsMutex);
     auto it = rooms.find(roomId);
-    if (it != rooms.end()) return &it->second;
-    return nullptr;
+    if (it == rooms.end()) {
+        return false;
+    }
+    out = it->second;
+    return true;
 }
 
-Room* RoomService::getRoomByUsername(const std::string& username) {
-    // WARNING: Not thread safe.
-    for (auto& pair : rooms) {
-        for (const auto& player : pair.second.players) {
-            if (player.username == username) {
-                return &pair.second;
-            }
-        }
+bool RoomService::getRoomByUsername(const std::string& username, Room& out) {
+    std::lock_guard<std::mutex> lock(roomsMutex);
+    auto membership = roomMembership.find(username);
+    if (membership == roomMembership.end()) {
+        return false;
+    }
+    auto it = rooms.find(membership->second.front());
+    if (it == rooms.end()) {
+        return false;
     }
-    return nullptr;
+    out = it->second;
+    return true;
 }
 
 void RoomService::updatePlayerState(uint32_t roomId, const std::string& username, PlayerState newState) {
@@ -202,6 +222,68 @@ void RoomService::updateRoomState(uint32_t roomId, RoomState newState) {
     }
 }
 
+std::vector<Room> RoomService::getAllRooms() {
+    std::lock_guard<std::mutex> lock(roomsMutex);
+    std::vector<Room> result;
+    result.reserve(rooms.size());
+    for (const auto& pair : rooms) {
+        result.push_back(pair.second);
+    }
+    return result;
+}
+
+void RoomService::saveState(ByteBuffer& out) {
+    std::lock_guard<std::mutex> lock(roomsMutex);
+    out.write_u32(nextRoomId.load());
+    out.write_u32((uint32_t)rooms.size());
+    for (const auto& pair : rooms) {
+        const Room& room = pair.second;
+        out.write_u32(room.id);
+        out.write_string(room.name);
+        out.write_string(room.host_username);
+        out.write_u8((uint8_t)room.state);
+        out.write_u8((uint8_t)room.players.size());
+        for (const auto& player : room.players) {
+            out.write_string(player.username);
+            out.write_u8((uint8_t)player.state);
+        }
+    }
+}
+
+std::function<void()> RoomService::parseState(ByteBuffer& in) {
+    uint32_t nextId = in.read_u32();
+    std::unordered_map<uint32_t, Room> loaded;
+    uint32_t count = in.read_u32();
+    for (uint32_t i = 0; i < count; ++i) {
+        Room room;
+        room.id = in.read_u32();
+        room.name = in.read_string();
+        room.host_username = in.read_string();
+        room.state = (RoomState)in.read_u8();
+        uint8_t players = in.read_u8();
+        for (uint8_t p = 0; p < players; ++p) {
+            PlayerInfo player;
+            player.username = in.read_string();
+            player.state = (PlayerState)in.read_u8();
+            player.clientFd = -1;
+            room.players.push_back(player);
+        }
+        loaded[room.id] = std::move(room);
+    }
+
+    return [this, nextId, loaded = std::move(loaded)]() mutable {
+        std::lock_guard<std::mutex> lock(roomsMutex);
+        rooms = std::move(loaded);
+        roomMembership.clear();
+        for (const auto& pair : rooms) {
+            for (const auto& player : pair.second.players) {
+                addMembership(player.username, pair.first);
+            }
+        }
+        nextRoomId = nextId;
+    };
+}
+
 std::vector<PlayerInfo> RoomService::getRoomPlayers(uint32_t roomId) {
     std::lock_guard<std::mutex> lock(roomsMutex);
     auto it = rooms.find(roomId);
@@ -246,6 +328,7 @@ S2C_CreateRoomResult RoomService::joinRoom(uint32_t roomId, const std::string& u
     info.clientFd = clientFd;
     info.state = PlayerState::PREPARING;
     room.players.push_back(info);
+    addMembership(username, roomId);
     
     result.code = ResultCode::SUCCESS;
     result.message = "Joined room successfully";
@@ -261,10 +344,31 @@ void RoomService::kickPlayer(uint32_t roomId, const std::string& username) {
         for (auto pIt = players.begin(); pIt != players.end(); ++pIt) {
             if (pIt->username == username) {
                 players.erase(pIt);
+                removeMembership(username, roomId);
                 break;
             }
         }
     }
 }
 
+void RoomService::rebindClient(const std::string& username, int fromFd, int toFd) {
+    std::lock_guard<std::mutex> lock(roomsMutex);
+    auto membership = roomMembership.find(username);
+    if (membership == roomMembership.end()) {
+        return;
+    }
+    // Only the user's own rooms, not every room on the server
+    for (uint32_t roomId : membership->second) {
+        auto it = rooms.find(roomId);
+        if (it == rooms.end()) {
+            continue;
+        }
+        for (auto& player : it->second.players) {
+            if (player.username == username && (player.clientFd == fromFd || player.clientFd < 0)) {
+                player.clientFd = toFd;
+            }
+        }
+    }
+}
+
 } // namespace hangman
@@ -0,0 +1,111 @@
+#include "service/StateSnapshot.h"
+#include "service/AuthService.h"
+#include "service/RoomService.h"
+#include "service/MatchService.h"
+#include "protocol/bytebuffer.h"
+#include "util/Logger.h"
+#include "util/Metrics.h"
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hangman {
+
+bool StateSnapshot::save(const std::string& path) {
+    uint64_t start = Metrics::nowNs();
+
+    ByteBuffer out(64 * 1024);
+    out.write_u32(MAGIC);
+    out.write_u32(FORMAT_VERSION);
+    AuthService::getInstance().saveState(out);
+    RoomService::getInstance().saveState(out);
+    MatchService::getInstance().saveState(out);
+
+    // Write next to the target, then rename: readers see the old or the new file.
+    // Owner-only: the snapshot holds session secrets (live tokens)
+    // (fchmod too, in case a stale tmp file was left with other bits).
+    std::string tmpPath = path + ".tmp";
+    int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (fd < 0 || fchmod(fd, 0600) != 0) {
+        LOG_ERROR("Snapshot: cannot open %s: %s", tmpPath.c_str(), strerror(errno));
+        if (fd >= 0) {
+            close(fd);
+        }
+        return false;
+    }
+    size_t written = 0;
+    while (written < out.size()) {
+        ssize_t n = write(fd, out.data() + written, out.size() - written);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            LOG_ERROR("Snapshot: write to %s failed: %s", tmpPath.c_str(), strerror(errno));
+            close(fd);
+            unlink(tmpPath.c_str());
+            return false;
+        }
+        written += (size_t)n;
+    }
+    if (fsync(fd) != 0 || close(fd) != 0) {
+        LOG_ERROR("Snapshot: flushing %s failed: %s", tmpPath.c_str(), strerror(errno));
+        unlink(tmpPath.c_str());
+        return false;
+    }
+    if (rename(tmpPath.c_str(), path.c_str()) != 0) {
+        LOG_ERROR("Snapshot: rename to %s failed: %s", path.c_str(), strerror(errno));
+        unlink(tmpPath.c_str());
+        return false;
+    }
+
+    LOG_INFO("Snapshot saved to %s (%zu bytes, %.1f ms)", path.c_str(), out.size(),
+             (Metrics::nowNs() - start) / 1e6);
+    return true;
+}
+
+bool StateSnapshot::load(const std::string& path) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        if (errno != ENOENT) {
+            LOG_ERROR("Snapshot: cannot open %s: %s", path.c_str(), strerror(errno));
+            return false;
+        }
+        return true;
+    }
+    ByteBuffer in;
+    uint8_t chunk[64 * 1024];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        in.write_bytes(chunk, n);
+    }
+    fclose(file);
+
+    try {
+        if (in.read_u32() != MAGIC || in.read_u32() != FORMAT_VERSION) {
+            LOG_ERROR("Snapshot: %s has an unknown format, ignored", path.c_str());
+            return false;
+        }
+        // Parse every section before installing any: a corrupt file
+        // must not leave sessions restored without their rooms
+        std::function<void()> sessions = AuthService::getInstance().parseState(in);
+        std::function<void()> rooms = RoomService::getInstance().parseState(in);
+        std::function<void()> matches = MatchService::getInstance().parseState(in);
+        sessions();
+        rooms();
+        matches();
+    } catch (const std::exception& e) {
+        LOG_ERROR("Snapshot: %s is corrupt (%s), ignored", path.c_str(), e.what());
+        return false;
+    }
+
+    LOG_INFO("Snapshot restored from %s: %zu sessions, %zu rooms, %zu matches", path.c_str(),
+             AuthService::getInstance().getAllSessions().size(), RoomService::getInstance().getAllRooms().size(),
+             MatchService::getInstance().getActiveMatches().size());
+    return true;
+}
+
+} // namespace hangman
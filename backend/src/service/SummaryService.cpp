@@ -4,7 +4,6 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
-#include <iostream>
 
 using namespace std::filesystem;
 
@@ -19,11 +18,11 @@ SummaryService& SummaryService::getInstance() {
     return *g_summaryService;
 }
 
-S2C_HistoryList SummaryService::getHistory(const C2S_RequestHistory& request) {
+S2C_HistoryList SummaryService::getHistory(const C2S_RequestHistory& request, const std::string& boundUser) {
     S2C_HistoryList response;
     std::string username;
 
-    if (!AuthService::getInstance().validateSession(request.session_token, username)) {
+    if (!AuthService::getInstance().authenticate(request.session_token, boundUser, username)) {
         return response;
     }
 
@@ -69,34 +68,51 @@ S2C_HistoryList SummaryService::getHistory(const C2S_RequestHistory& request) {
     return response;
 }
 
-S2C_Leaderboard SummaryService::getLeaderboard(const C2S_RequestLeaderboard& request) {
+bool SummaryService::isLeaderboardCached() const {
+    std::lock_guard<std::mutex> lock(leaderboardMutex);
+    return cacheValid && cachedVersion == AuthService::getInstance().getStatsVersion();
+}
+
+S2C_Leaderboard SummaryService::getLeaderboard(const C2S_RequestLeaderboard& request, const std::string& boundUser) {
     S2C_Leaderboard response;
     std::string username;
 
-    if (!AuthService::getInstance().validateSession(request.session_token, username)) {
+    if (!AuthService::getInstance().authenticate(request.session_token, boundUser, username)) {
         return response;
     }
 
+    // Read the version before the users: a concurrent update makes the
+    // version newer than the cache, never the other way round
+    uint64_t version = AuthService::getInstance().getStatsVersion();
+    {
+        std::lock_guard<std::mutex> lock(leaderboardMutex);
+        if (cacheValid && cachedVersion == version) {
+            response.rows = cachedRows;
+            return response;
+        }
+    }
+
     auto users = AuthService::getInstance().getAllUsers();
-    
-    // Sort by points desc
-    std::sort(users.begin(), users.end(), [](const User& a, const User& b) {
+
+    // Sort by points desc, top 10 only
+    size_t count = std::min(users.size(), LEADERBOARD_SIZE);
+    std::partial_sort(users.begin(), users.begin() + count, users.end(), [](const User& a, const User& b) {
         return a.total_points > b.total_points;
     });
 
-    // Take top 10
-    int count = 0;
-    for (const auto& u : users) {
-        if (count >= 10) break;
+    for (size_t i = 0; i < count; ++i) {
         S2C_Leaderboard::Row row;
-        row.username = u.username;
-        row.wins = u.wins;
+        row.username = users[i].username;
+        row.wins = users[i].wins;
         row.losses = 0; // Not tracked in User struct currently
         row.draws = 0;  // Not tracked
         response.rows.push_back(row);
-        count++;
     }
 
+    std::lock_guard<std::mutex> lock(leaderboardMutex);
+    cachedRows = response.rows;
+    cachedVersion = version;
+    cacheValid = true;
     return response;
 }
 
@@ -1,4 +1,7 @@
 #include "threading/CallbackQueue.h"
+#include "threading/Task.h"
+#include "util/Metrics.h"
+#include "util/Logger.h"
 #include <sys/eventfd.h>
 #include <unistd.h>
 #include <stdexcept>
@@ -20,29 +23,54 @@ CallbackQueue::~CallbackQueue() {
     }
 }
 
+void TaskBatchCallback::execute() {
+    Metrics& metrics = Metrics::getInstance();
+    uint64_t now = Metrics::nowNs();
+    for (const TaskPtr& task : tasks) {
+        metrics.record(MetricStage::CALLBACK_DELAY, task->getPacketType(), now - enqueuedAt);
+        try {
+            deliver(*task);
+        } catch (const std::exception& e) {
+            // One bad result must not drop the rest of the batch
+            LOG_ERROR("Error delivering task result: %s", e.what());
+        }
+    }
+}
+
 void CallbackQueue::push(CallbackPtr callback) {
+    callback->enqueuedAt = Metrics::nowNs();
+    bool wasEmpty;
     {
         std::lock_guard<std::mutex> lock(mutex);
-        queue.push(callback);
+        wasEmpty = queue.empty();
+        queue.push(std::move(callback));
     }
-    
+
     // Signal epoll that callbacks are available
-    uint64_t value = 1;
-    write(notifyFd, &value, sizeof(value));
+    if (wasEmpty) {
+        uint64_t value = 1;
+        write(notifyFd, &value, sizeof(value));
+    }
 }
 
 std::vector<CallbackPtr> CallbackQueue::popAll() {
     std::vector<CallbackPtr> result;
     {
         std::lock_guard<std::mutex> lock(mutex);
+        result.reserve(queue.size());
         while (!queue.empty()) {
-            result.push_back(queue.front());
+            result.push_back(std::move(queue.front()));
             queue.pop();
         }
     }
     return result;
 }
 
+size_t CallbackQueue::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return queue.size();
+}
+
 void CallbackQueue::resetNotification() {
     // Read from eventfd to reset it
     uint64_t value;
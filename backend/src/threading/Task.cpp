@@ -4,6 +4,7 @@
 #include "service/BeforePlayService.h"
 #include "service/MatchService.h"
 #include "service/SummaryService.h"
+#include "service/StateSnapshot.h"
 
 namespace hangman {
 
@@ -17,30 +18,85 @@ std::vector<uint8_t> RegisterTask::getResponsePacket() const {
     return result.to_bytes();
 }
 
+void RegisterTask::rejectBusy() {
+    result.code = ResultCode::SERVER_ERROR;
+    result.message = "Server busy, try again later";
+}
+
 // ============ LoginTask ============
 
 void LoginTask::execute() {
     result = AuthService::getInstance().login(request, clientFd);
+    if (result.code == ResultCode::SUCCESS) {
+        binding = {clientFd, request.username, result.session_token};
+    }
+}
+
+const SessionBinding* LoginTask::getSessionBinding() const {
+    return binding.clientFd != -1 ? &binding : nullptr;
 }
 
 std::vector<uint8_t> LoginTask::getResponsePacket() const {
     return result.to_bytes();
 }
 
+void LoginTask::rejectBusy() {
+    result.code = ResultCode::SERVER_ERROR;
+    result.message = "Server busy, try again later";
+}
+
 // ============ LogoutTask ============
 
 void LogoutTask::execute() {
+    if (request.session_token.empty()) {
+        request.session_token = boundToken;
+    }
+    // The session may be bound to another connection: release that one
+    Session session;
+    bool known = AuthService::getInstance().getSessionInfo(request.session_token, session);
     result = AuthService::getInstance().logout(request);
+    if (known && result.code == ResultCode::SUCCESS) {
+        binding = {session.clientFd, std::string(), request.session_token};
+    }
+}
+
+const SessionBinding* LogoutTask::getSessionBinding() const {
+    return binding.clientFd != -1 ? &binding : nullptr;
 }
 
 std::vector<uint8_t> LogoutTask::getResponsePacket() const {
     return result.to_bytes();
 }
 
+// ============ ResumeSessionTask ============
+
+void ResumeSessionTask::execute() {
+    Session session;
+    int previousFd = -1;
+    if (!AuthService::getInstance().resumeSession(request.session_token, clientFd, session, previousFd)) {
+        result = {ResultCode::AUTH_FAIL, "Invalid session token", "", 0, 0};
+        return;
+    }
+    // Room notifications follow the session to the new connection
+    RoomService::getInstance().rebindClient(session.username, previousFd, clientFd);
+
+    result = {ResultCode::SUCCESS, "Session resumed", session.username,
+              (uint16_t)session.wins, (uint16_t)session.total_points};
+    binding = {clientFd, session.username, request.session_token, previousFd};
+}
+
+const SessionBinding* ResumeSessionTask::getSessionBinding() const {
+    return binding.clientFd != -1 ? &binding : nullptr;
+}
+
+std::vector<uint8_t> ResumeSessionTask::getResponsePacket() const {
+    return result.to_bytes();
+}
+
 // ============ CreateRoomTask ============
 
 void CreateRoomTask::execute() {
-    result = RoomService::getInstance().createRoom(request, clientFd);
+    result = RoomService::getInstance().createRoom(request, clientFd, boundUser);
 }
 
 std::vector<uint8_t> CreateRoomTask::getResponsePacket() const {
@@ -50,25 +106,21 @@ std::vector<uint8_t> CreateRoomTask::getResponsePacket() const {
 // ============ LeaveRoomTask ============
 
 void LeaveRoomTask::execute() {
-    fullResult = RoomService::getInstance().leaveRoom(request, clientFd);
+    fullResult = RoomService::getInstance().leaveRoom(request, clientFd, boundUser);
+    for (const auto& item : fullResult.broadcastPackets) {
+        broadcasts.push_back({makeSharedPacket(item.second.to_bytes()), {item.first}});
+    }
 }
 
 std::vector<uint8_t> LeaveRoomTask::getResponsePacket() const {
     return fullResult.ackPacket.to_bytes();
 }
 
-std::vector<std::pair<int, std::vector<uint8_t>>> LeaveRoomTask::getBroadcastPackets() const {
-    std::vector<std::pair<int, std::vector<uint8_t>>> packets;
-    for (const auto& item : fullResult.broadcastPackets) {
-        packets.push_back({item.first, item.second.to_bytes()});
-    }
-    return packets;
-}
 
 // ============ RequestOnlineListTask ============
 
 void RequestOnlineListTask::execute() {
-    result = BeforePlayService::getInstance().getOnlineList(request);
+    result = BeforePlayService::getInstance().getOnlineList(request, boundUser);
 }
 
 std::vector<uint8_t> RequestOnlineListTask::getResponsePacket() const {
@@ -78,7 +130,7 @@ std::vector<uint8_t> RequestOnlineListTask::getResponsePacket() const {
 // ============ SendInviteTask ============
 
 void SendInviteTask::execute() {
-    auto res = BeforePlayService::getInstance().sendInvite(request, clientFd);
+    auto res = BeforePlayService::getInstance().sendInvite(request, clientFd, boundUser);
     
     if (res.success) {
         result.code = ResultCode::SUCCESS;
@@ -86,7 +138,7 @@ void SendInviteTask::execute() {
         result.ack_for_type = static_cast<uint16_t>(PacketType::C2S_SendInvite);
         
         if (res.targetFd != -1) {
-            broadcastPackets.push_back({res.targetFd, res.invitePacket.to_bytes()});
+            broadcasts.push_back({makeSharedPacket(res.invitePacket.to_bytes()), {res.targetFd}});
         }
     } else {
         result.code = ResultCode::FAIL;
@@ -99,14 +151,10 @@ std::vector<uint8_t> SendInviteTask::getResponsePacket() const {
     return result.to_bytes();
 }
 
-std::vector<std::pair<int, std::vector<uint8_t>>> SendInviteTask::getBroadcastPackets() const {
-    return broadcastPackets;
-}
-
 // ============ RespondInviteTask ============
 
 void RespondInviteTask::execute() {
-    auto res = BeforePlayService::getInstance().respondInvite(request, clientFd);
+    auto res = BeforePlayService::getInstance().respondInvite(request, clientFd, boundUser);
     accepted = request.accept;
     
     if (accepted) {
@@ -117,7 +165,7 @@ void RespondInviteTask::execute() {
     }
     
     if (res.senderFd != -1) {
-        broadcastPackets.push_back({res.senderFd, res.responsePacket.to_bytes()});
+        broadcasts.push_back({makeSharedPacket(res.responsePacket.to_bytes()), {res.senderFd}});
     }
 }
 
@@ -128,26 +176,24 @@ std::vector<uint8_t> RespondInviteTask::getResponsePacket() const {
     return {}; 
 }
 
-std::vector<std::pair<int, std::vector<uint8_t>>> RespondInviteTask::getBroadcastPackets() const {
-    return broadcastPackets;
-}
-
 // ============ SetReadyTask ============
 
 void SetReadyTask::execute() {
-    auto res = BeforePlayService::getInstance().setReady(request, clientFd);
+    auto res = BeforePlayService::getInstance().setReady(request, clientFd, boundUser);
     
     result = res.ackPacket;
     
     if (res.hostFd != -1) {
-         broadcastPackets.push_back(std::make_pair(res.hostFd, res.updatePacket.to_bytes()));
+        broadcasts.push_back({makeSharedPacket(res.updatePacket.to_bytes()), {res.hostFd}});
     }
     
     if (res.gameStarted) {
-        broadcastPackets.push_back(std::make_pair(clientFd, res.gameStartPacket.to_bytes()));
+        // Same GameStart for both players: encode once
+        Broadcast start{makeSharedPacket(res.gameStartPacket.to_bytes()), {clientFd}};
         if (res.hostFd != -1) {
-            broadcastPackets.push_back(std::make_pair(res.hostFd, res.gameStartPacket.to_bytes()));
+            start.targets.push_back(res.hostFd);
         }
+        broadcasts.push_back(std::move(start));
     }
 }
 
@@ -155,24 +201,21 @@ std::vector<uint8_t> SetReadyTask::getResponsePacket() const {
     return result.to_bytes();
 }
 
-std::vector<std::pair<int, std::vector<uint8_t>>> SetReadyTask::getBroadcastPackets() const {
-    return broadcastPackets;
-}
-
 // ============ StartGameTask ============
 
 void StartGameTask::execute() {
-    auto res = BeforePlayService::getInstance().startGame(request, clientFd);
+    auto res = BeforePlayService::getInstance().startGame(request, clientFd, boundUser);
     
     if (res.success) {
         result.code = ResultCode::SUCCESS;
         result.message = "Game started";
         result.ack_for_type = static_cast<uint16_t>(PacketType::C2S_StartGame);
         
-        broadcastPackets.push_back(std::make_pair(clientFd, res.gameStartPacket.to_bytes()));
+        Broadcast start{makeSharedPacket(res.gameStartPacket.to_bytes()), {clientFd}};
         if (res.opponentFd != -1) {
-            broadcastPackets.push_back(std::make_pair(res.opponentFd, res.gameStartPacket.to_bytes()));
+            start.targets.push_back(res.opponentFd);
         }
+        broadcasts.push_back(std::move(start));
     } else {
         result.code = ResultCode::FAIL;
         result.message = res.errorPacket.message;
@@ -184,14 +227,10 @@ std::vector<uint8_t> StartGameTask::getResponsePacket() const {
     return result.to_bytes();
 }
 
-std::vector<std::pair<int, std::vector<uint8_t>>> StartGameTask::getBroadcastPackets() const {
-    return broadcastPackets;
-}
-
 // ============ KickPlayerTask ============
 
 void KickPlayerTask::execute() {
-    auto res = BeforePlayService::getInstance().kickPlayer(request, clientFd);
+    auto res = BeforePlayService::getInstance().kickPlayer(request, clientFd, boundUser);
     
     result = res.resultPacket;
     
@@ -199,7 +238,7 @@ void KickPlayerTask::execute() {
         S2C_Error error;
         error.for_type = 0;
         error.message = "You have been kicked from the room";
-        broadcastPackets.push_back(std::make_pair(res.targetFd, error.to_bytes()));
+        broadcasts.push_back({makeSharedPacket(error.to_bytes()), {res.targetFd}});
     }
 }
 
@@ -207,14 +246,10 @@ std::vector<uint8_t> KickPlayerTask::getResponsePacket() const {
     return result.to_bytes();
 }
 
-std::vector<std::pair<int, std::vector<uint8_t>>> KickPlayerTask::getBroadcastPackets() const {
-    return broadcastPackets;
-}
-
 // ============ GuessCharTask ============
 
 void GuessCharTask::execute() {
-    auto res = MatchService::getInstance().guessChar(request);
+    auto res = MatchService::getInstance().guessChar(request, boundUser);
     success = res.success;
     if (success) {
         result = res.resultPacket;
@@ -231,7 +266,7 @@ std::vector<uint8_t> GuessCharTask::getResponsePacket() const {
 // ============ GuessWordTask ============
 
 void GuessWordTask::execute() {
-    auto res = MatchService::getInstance().guessWord(request);
+    auto res = MatchService::getInstance().guessWord(request, boundUser);
     success = res.success;
     if (success) {
         result = res.resultPacket;
@@ -248,9 +283,9 @@ std::vector<uint8_t> GuessWordTask::getResponsePacket() const {
 // ============ RequestDrawTask ============
 
 void RequestDrawTask::execute() {
-    auto res = MatchService::getInstance().requestDraw(request);
+    auto res = MatchService::getInstance().requestDraw(request, boundUser);
     if (res.first != -1) {
-        broadcastPackets.push_back({res.first, res.second.to_bytes()});
+        broadcasts.push_back({makeSharedPacket(res.second.to_bytes()), {res.first}});
     }
 }
 
@@ -258,19 +293,15 @@ std::vector<uint8_t> RequestDrawTask::getResponsePacket() const {
     return {}; // No direct response to sender, maybe Ack? Protocol doesn't specify Ack for this.
 }
 
-std::vector<std::pair<int, std::vector<uint8_t>>> RequestDrawTask::getBroadcastPackets() const {
-    return broadcastPackets;
-}
-
 // ============ EndGameTask ============
 
 void EndGameTask::execute() {
-    auto res = MatchService::getInstance().endGame(request);
+    auto res = MatchService::getInstance().endGame(request, boundUser);
     success = res.success;
     if (success) {
         result = res.endPacket;
         if (res.opponentFd != -1) {
-            broadcastPackets.push_back({res.opponentFd, result.to_bytes()});
+            broadcasts.push_back({makeSharedPacket(result.to_bytes()), {res.opponentFd}});
         }
     } else {
         error = res.errorPacket;
@@ -282,14 +313,10 @@ std::vector<uint8_t> EndGameTask::getResponsePacket() const {
     return error.to_bytes();
 }
 
-std::vector<std::pair<int, std::vector<uint8_t>>> EndGameTask::getBroadcastPackets() const {
-    return broadcastPackets;
-}
-
 // ============ RequestHistoryTask ============
 
 void RequestHistoryTask::execute() {
-    result = SummaryService::getInstance().getHistory(request);
+    result = SummaryService::getInstance().getHistory(request, boundUser);
 }
 
 std::vector<uint8_t> RequestHistoryTask::getResponsePacket() const {
@@ -299,12 +326,28 @@ std::vector<uint8_t> RequestHistoryTask::getResponsePacket() const {
 // ============ RequestLeaderboardTask ============
 
 void RequestLeaderboardTask::execute() {
-    result = SummaryService::getInstance().getLeaderboard(request);
+    result = SummaryService::getInstance().getLeaderboard(request, boundUser);
 }
 
 std::vector<uint8_t> RequestLeaderboardTask::getResponsePacket() const {
     return result.to_bytes();
 }
 
+bool RequestLeaderboardTask::isNonBlocking() const {
+    return SummaryService::getInstance().isLeaderboardCached();
+}
+
+// ============ SnapshotTask ============
+
+void SnapshotTask::execute() {
+    StateSnapshot::save(path);
+}
+
+// ============ FlushUsersTask ============
+
+void FlushUsersTask::execute() {
+    AuthService::getInstance().flushUsers();
+}
+
 } // namespace hangman
 
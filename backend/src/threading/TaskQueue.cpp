@@ -1,34 +1,77 @@
 #include "threading/TaskQueue.h"
 #include "threading/Task.h"
+#include "util/Metrics.h"
 
 namespace hangman {
 
 void TaskQueue::push(TaskPtr task) {
+    task->enqueuedAt = Metrics::nowNs();
+    uint64_t key = task->getActorKey();
+    bool wake = false;
     {
         std::lock_guard<std::mutex> lock(mutex);
         if (stopped) {
             return;  // Ignore tasks after stop
         }
-        queue.push(task);
+        Mailbox& mailbox = mailboxes[key];
+        mailbox.tasks.push_back(std::move(task));
+        ++queued;
+        if (!mailbox.scheduled) {
+            mailbox.scheduled = true;
+            readyKeys.push_back(key);
+            wake = true;
+        }
+    }
+    // Tasks behind a running actor need no worker until done()
+    if (wake) {
+        cv.notify_one();
     }
-    cv.notify_one();
 }
 
-TaskPtr TaskQueue::pop() {
+size_t TaskQueue::popBatch(std::vector<TaskPtr>& out, size_t max) {
     std::unique_lock<std::mutex> lock(mutex);
-    
-    // Wait until queue has elements or is stopped
+
+    // Wait until an actor is ready or the queue is stopped
     cv.wait(lock, [this] {
-        return !queue.empty() || stopped;
+        return !readyKeys.empty() || stopped;
     });
 
-    if (queue.empty()) {
-        return nullptr;  // Stopped and no more tasks
+    if (readyKeys.empty()) {
+        return 0;  // Stopped and nothing left to run
+    }
+
+    uint64_t key = readyKeys.front();
+    readyKeys.pop_front();
+    Mailbox& mailbox = mailboxes[key];
+
+    size_t count = 0;
+    while (!mailbox.tasks.empty() && count < max) {
+        out.push_back(std::move(mailbox.tasks.front()));
+        mailbox.tasks.pop_front();
+        ++count;
     }
+    queued -= count;
+    return count;
+}
 
-    TaskPtr task = queue.front();
-    queue.pop();
-    return task;
+void TaskQueue::done(uint64_t key) {
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = mailboxes.find(key);
+        if (it == mailboxes.end()) {
+            return;
+        }
+        if (it->second.tasks.empty()) {
+            mailboxes.erase(it);  // Idle actors cost nothing
+        } else {
+            readyKeys.push_back(key);  // Back of the line: other actors get a turn
+            wake = true;
+        }
+    }
+    if (wake) {
+        cv.notify_one();
+    }
 }
 
 void TaskQueue::stop() {
@@ -41,12 +84,17 @@ void TaskQueue::stop() {
 
 bool TaskQueue::empty() const {
     std::lock_guard<std::mutex> lock(mutex);
-    return queue.empty();
+    return queued == 0;
 }
 
 size_t TaskQueue::size() const {
     std::lock_guard<std::mutex> lock(mutex);
-    return queue.size();
+    return queued;
+}
+
+size_t TaskQueue::actorCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return mailboxes.size();
 }
 
 } // namespace hangman
@@ -0,0 +1,178 @@
+#include "util/Logger.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <unistd.h>
+
+namespace hangman {
+
+static Logger* g_logger = nullptr;
+
+Logger& Logger::getInstance() {
+    if (!g_logger) {
+        g_logger = new Logger();
+    }
+    return *g_logger;
+}
+
+Logger::Logger() : slots(new Slot[SLOT_COUNT]) {
+    for (size_t i = 0; i < SLOT_COUNT; ++i) {
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+Logger::~Logger() {
+    stop();
+    delete[] slots;
+}
+
+static uint64_t nowMs() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+// "HH:MM:SS.mmm LEVEL text\n"; line must hold sizeof(Slot::text) + 64 bytes
+static size_t formatLine(char* line, LogLevel level, uint64_t timestampMs, const char* text, size_t length) {
+    static const char* names[] = {"DEBUG", "INFO ", "WARN ", "ERROR"};
+    time_t seconds = (time_t)(timestampMs / 1000);
+    struct tm tmBuf;
+    localtime_r(&seconds, &tmBuf);
+    size_t prefix = strftime(line, 32, "%H:%M:%S", &tmBuf);
+    prefix += snprintf(line + prefix, 32, ".%03u %s ", (unsigned)(timestampMs % 1000), names[(int)level & 3]);
+    std::memcpy(line + prefix, text, length);
+    line[prefix + length] = '\n';
+    return prefix + length + 1;
+}
+
+void Logger::start() {
+    if (running.exchange(true)) {
+        return;
+    }
+    flusher = std::thread(&Logger::flusherLoop, this);
+}
+
+void Logger::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+    drain();  // Anything pushed while the flusher was exiting
+}
+
+void Logger::log(LogLevel level, const char* fmt, ...) {
+    char text[sizeof(Slot::text)];
+    va_list args;
+    va_start(args, fmt);
+    int n = vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+    if (n < 0) {
+        return;
+    }
+    size_t length = std::min((size_t)n, sizeof(text) - 1);
+    uint64_t timestamp = nowMs();
+
+    if (!running.load(std::memory_order_acquire)) {
+        writeLine(level, timestamp, text, length);
+        return;
+    }
+    if (!tryPush(level, timestamp, text, length)) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Bounded MPMC ring (per-slot sequence numbers): a producer claims a slot by
+// CAS on enqueuePos and publishes it by bumping the slot sequence.
+bool Logger::tryPush(LogLevel level, uint64_t timestampMs, const char* text, size_t length) {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = &slots[pos & MASK];
+        size_t seq = slot->sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0) {
+            if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;  // Full
+        } else {
+            pos = enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->timestampMs = timestampMs;
+    slot->level = level;
+    slot->length = (uint16_t)length;
+    std::memcpy(slot->text, text, length);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+// Flusher side: pop every published slot, batching output per stream
+size_t Logger::drain() {
+    std::string& out = outBatch;
+    std::string& err = errBatch;
+    out.clear();
+    err.clear();
+    size_t count = 0;
+
+    while (true) {
+        Slot& slot = slots[dequeuePos & MASK];
+        size_t seq = slot.sequence.load(std::memory_order_acquire);
+        if (seq != dequeuePos + 1) {
+            break;  // Empty (or the next producer has not published yet)
+        }
+
+        char line[sizeof(Slot::text) + 64];
+        size_t lineLen = formatLine(line, slot.level, slot.timestampMs, slot.text, slot.length);
+        std::string& target = slot.level >= LogLevel::WARN ? err : out;
+        target.append(line, lineLen);
+
+        slot.sequence.store(dequeuePos + SLOT_COUNT, std::memory_order_release);
+        ++dequeuePos;
+        ++count;
+    }
+
+    uint64_t droppedNow = dropped.load(std::memory_order_relaxed);
+    if (droppedNow != reportedDropped) {
+        char note[64];
+        int n = snprintf(note, sizeof(note), "[logger] %llu message(s) dropped\n",
+                         (unsigned long long)(droppedNow - reportedDropped));
+        err.append(note, n);
+        reportedDropped = droppedNow;
+    }
+
+    if (!out.empty()) {
+        ssize_t ignored = ::write(STDOUT_FILENO, out.data(), out.size());
+        (void)ignored;
+    }
+    if (!err.empty()) {
+        ssize_t ignored = ::write(STDERR_FILENO, err.data(), err.size());
+        (void)ignored;
+    }
+    return count;
+}
+
+void Logger::flusherLoop() {
+    while (running.load(std::memory_order_acquire)) {
+        if (drain() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+}
+
+// Synchronous path used outside start()/stop()
+void Logger::writeLine(LogLevel level, uint64_t timestampMs, const char* text, size_t length) {
+    char line[sizeof(Slot::text) + 64];
+    size_t lineLen = formatLine(line, level, timestampMs, text, length);
+    ssize_t ignored = ::write(level >= LogLevel::WARN ? STDERR_FILENO : STDOUT_FILENO, line, lineLen);
+    (void)ignored;
+}
+
+} // namespace hangman
@@ -0,0 +1,263 @@
+#include "util/Metrics.h"
+#include "protocol/packet_types.h"
+#include <chrono>
+#include <cstdio>
+
+namespace hangman {
+
+// ============ LatencyHistogram ============
+
+size_t LatencyHistogram::bucketIndex(uint64_t value) {
+    const uint64_t maxValue = (1ull << (MAX_BIT + 1)) - 1;
+    if (value > maxValue) {
+        value = maxValue;
+    }
+    if (value < SUB_COUNT) {
+        return (size_t)value;
+    }
+    unsigned msb = 63 - __builtin_clzll(value);
+    unsigned magnitude = msb - SUB_BITS + 1;
+    return magnitude * SUB_COUNT + ((value >> (msb - SUB_BITS)) & (SUB_COUNT - 1));
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < SUB_COUNT) {
+        return index;
+    }
+    size_t magnitude = index / SUB_COUNT;
+    uint64_t sub = index % SUB_COUNT;
+    return ((SUB_COUNT + sub + 1) << (magnitude - 1)) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    // Single writer: plain load/store instead of locked read-modify-write
+    std::atomic<uint64_t>& bucket = buckets[bucketIndex(value)];
+    bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    total.store(total.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    sum.store(sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    if (value > maxValue.load(std::memory_order_relaxed)) {
+        maxValue.store(value, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::mergeInto(uint64_t* out, uint64_t& count, uint64_t& outSum, uint64_t& outMax) const {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        out[i] += buckets[i].load(std::memory_order_relaxed);
+    }
+    count += total.load(std::memory_order_relaxed);
+    outSum += sum.load(std::memory_order_relaxed);
+    uint64_t m = maxValue.load(std::memory_order_relaxed);
+    if (m > outMax) {
+        outMax = m;
+    }
+}
+
+// ============ Metrics ============
+
+static Metrics* g_metrics = nullptr;
+
+Metrics& Metrics::getInstance() {
+    if (!g_metrics) {
+        g_metrics = new Metrics();
+    }
+    return *g_metrics;
+}
+
+uint64_t Metrics::nowNs() {
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+size_t Metrics::typeSlot(uint16_t packetType) {
+    unsigned group = packetType >> 8;
+    unsigned index = packetType & 0xFF;
+    if (group >= 1 && group <= 6 && index < 16) {
+        return (group - 1) * 16 + index;
+    }
+    return TYPE_SLOTS - 1;
+}
+
+uint16_t Metrics::slotType(size_t slot) {
+    if (slot >= TYPE_SLOTS - 1) {
+        return 0;
+    }
+    return (uint16_t)(((slot / 16 + 1) << 8) | (slot % 16));
+}
+
+Metrics::ThreadBlock& Metrics::local() {
+    thread_local ThreadBlock* block = nullptr;
+    if (!block) {
+        block = new ThreadBlock();
+        std::lock_guard<std::mutex> lock(registryMutex);
+        threads.push_back(block);
+    }
+    return *block;
+}
+
+void Metrics::record(MetricStage stage, uint16_t packetType, uint64_t nanos) {
+    std::atomic<LatencyHistogram*>& slot = local().histograms[(size_t)stage][typeSlot(packetType)];
+    LatencyHistogram* histogram = slot.load(std::memory_order_relaxed);
+    if (!histogram) {
+        histogram = new LatencyHistogram();
+        slot.store(histogram, std::memory_order_release);
+    }
+    histogram->record(nanos);
+}
+
+void Metrics::increment(MetricCounter counter, uint64_t n) {
+    std::atomic<uint64_t>& value = local().counters[(size_t)counter];
+    value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+uint64_t Metrics::counterValue(MetricCounter counter) const {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    uint64_t total = 0;
+    for (const ThreadBlock* block : threads) {
+        total += block->counters[(size_t)counter].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+Metrics::Summary Metrics::summarize(MetricStage stage, uint16_t packetType) const {
+    std::vector<uint64_t> buckets(LatencyHistogram::BUCKET_COUNT, 0);
+    uint64_t count = 0;
+    uint64_t sum = 0;
+    Summary summary;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const ThreadBlock* block : threads) {
+            const LatencyHistogram* histogram =
+                block->histograms[(size_t)stage][typeSlot(packetType)].load(std::memory_order_acquire);
+            if (histogram) {
+                histogram->mergeInto(buckets.data(), count, sum, summary.max);
+            }
+        }
+    }
+    if (count == 0) {
+        return summary;
+    }
+
+    summary.count = count;
+    summary.mean = sum / count;
+
+    // Percentile = upper bound of the bucket holding the q-th value (capped at max)
+    const double quantiles[] = {0.50, 0.90, 0.99};
+    uint64_t* targets[] = {&summary.p50, &summary.p90, &summary.p99};
+    size_t q = 0;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size() && q < 3; ++i) {
+        seen += buckets[i];
+        while (q < 3 && seen >= (uint64_t)(quantiles[q] * count + 0.5) && seen > 0) {
+            uint64_t bound = LatencyHistogram::bucketUpperBound(i);
+            *targets[q] = bound < summary.max ? bound : summary.max;
+            ++q;
+        }
+    }
+    return summary;
+}
+
+const char* Metrics::stageName(MetricStage stage) {
+    switch (stage) {
+        case MetricStage::QUEUE_WAIT: return "queue_wait";
+        case MetricStage::EXECUTE: return "execute";
+        case MetricStage::CALLBACK_DELAY: return "callback_delay";
+        case MetricStage::SEND: return "send";
+        default: return "unknown";
+    }
+}
+
+const char* Metrics::counterName(MetricCounter counter) {
+    switch (counter) {
+        case MetricCounter::PACKETS_IN: return "packets_in";
+        case MetricCounter::BYTES_IN: return "bytes_in";
+        case MetricCounter::PACKETS_OUT: return "packets_out";
+        case MetricCounter::BYTES_OUT: return "bytes_out";
+        case MetricCounter::CONNECTIONS_ACCEPTED: return "connections_accepted";
+        case MetricCounter::CONNECTIONS_CLOSED: return "connections_closed";
+        case MetricCounter::SLOW_CLIENT_DROPS: return "slow_client_drops";
+        case MetricCounter::AUTH_REJECTED: return "auth_rejected";
+        case MetricCounter::RATE_LIMITED: return "rate_limited";
+        case MetricCounter::SESSIONS_RESUMED: return "sessions_resumed";
+        case MetricCounter::OUTBOX_DROPPED: return "outbox_dropped";
+        default: return "unknown";
+    }
+}
+
+static const char* packetTypeName(uint16_t type) {
+    switch ((PacketType)type) {
+        case PacketType::C2S_Register: return "C2S_Register";
+        case PacketType::S2C_RegisterResult: return "S2C_RegisterResult";
+        case PacketType::C2S_Login: return "C2S_Login";
+        case PacketType::S2C_LoginResult: return "S2C_LoginResult";
+        case PacketType::C2S_Logout: return "C2S_Logout";
+        case PacketType::S2C_LogoutAck: return "S2C_LogoutAck";
+        case PacketType::C2S_ResumeSession: return "C2S_ResumeSession";
+        case PacketType::S2C_ResumeResult: return "S2C_ResumeResult";
+        case PacketType::C2S_CreateRoom: return "C2S_CreateRoom";
+        case PacketType::S2C_CreateRoomResult: return "S2C_CreateRoomResult";
+        case PacketType::C2S_LeaveRoom: return "C2S_LeaveRoom";
+        case PacketType::S2C_LeaveRoomAck: return "S2C_LeaveRoomAck";
+        case PacketType::S2C_PlayerLeftNotification: return "S2C_PlayerLeftNotification";
+        case PacketType::C2S_RequestOnlineList: return "C2S_RequestOnlineList";
+        case PacketType::S2C_OnlineList: return "S2C_OnlineList";
+        case PacketType::C2S_KickPlayer: return "C2S_KickPlayer";
+        case PacketType::S2C_KickResult: return "S2C_KickResult";
+        case PacketType::C2S_SendInvite: return "C2S_SendInvite";
+        case PacketType::S2C_InviteReceived: return "S2C_InviteReceived";
+        case PacketType::C2S_RespondInvite: return "C2S_RespondInvite";
+        case PacketType::S2C_InviteResponse: return "S2C_InviteResponse";
+        case PacketType::C2S_SetReady: return "C2S_SetReady";
+        case PacketType::S2C_PlayerReadyUpdate: return "S2C_PlayerReadyUpdate";
+        case PacketType::C2S_StartGame: return "C2S_StartGame";
+        case PacketType::S2C_GameStart: return "S2C_GameStart";
+        case PacketType::C2S_GuessChar: return "C2S_GuessChar";
+        case PacketType::S2C_GuessCharResult: return "S2C_GuessCharResult";
+        case PacketType::C2S_GuessWord: return "C2S_GuessWord";
+        case PacketType::S2C_GuessWordResult: return "S2C_GuessWordResult";
+        case PacketType::C2S_RequestDraw: return "C2S_RequestDraw";
+        case PacketType::S2C_DrawRequest: return "S2C_DrawRequest";
+        case PacketType::C2S_EndGame: return "C2S_EndGame";
+        case PacketType::S2C_GameEnd: return "S2C_GameEnd";
+        case PacketType::C2S_RequestHistory: return "C2S_RequestHistory";
+        case PacketType::S2C_HistoryList: return "S2C_HistoryList";
+        case PacketType::C2S_RequestLeaderboard: return "C2S_RequestLeaderboard";
+        case PacketType::S2C_Leaderboard: return "S2C_Leaderboard";
+        default: return nullptr;
+    }
+}
+
+std::string Metrics::snapshotText() const {
+    std::string out;
+    char line[256];
+
+    for (size_t c = 0; c < (size_t)MetricCounter::COUNT; ++c) {
+        snprintf(line, sizeof(line), "counter %s %llu\n", counterName((MetricCounter)c),
+                 (unsigned long long)counterValue((MetricCounter)c));
+        out += line;
+    }
+
+    // Latencies in microseconds
+    for (size_t s = 0; s < (size_t)MetricStage::COUNT; ++s) {
+        for (size_t slot = 0; slot < TYPE_SLOTS; ++slot) {
+            uint16_t type = slotType(slot);
+            Summary sum = summarize((MetricStage)s, slot == TYPE_SLOTS - 1 ? 0xFFFF : type);
+            if (sum.count == 0) {
+                continue;
+            }
+            const char* name = slot == TYPE_SLOTS - 1 ? "other" : packetTypeName(type);
+            char fallback[16];
+            if (!name) {
+                snprintf(fallback, sizeof(fallback), "0x%04x", type);
+                name = fallback;
+            }
+            snprintf(line, sizeof(line),
+                     "latency %s %s count=%llu mean_us=%.1f p50_us=%.1f p90_us=%.1f p99_us=%.1f max_us=%.1f\n",
+                     stageName((MetricStage)s), name, (unsigned long long)sum.count,
+                     sum.mean / 1000.0, sum.p50 / 1000.0, sum.p90 / 1000.0, sum.p99 / 1000.0, sum.max / 1000.0);
+            out += line;
+        }
+    }
+    return out;
+}
+
+} // namespace hangman
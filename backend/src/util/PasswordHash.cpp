@@ -0,0 +1,307 @@
+#include "util/PasswordHash.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/random.h>
+#include <unistd.h>
+#include <vector>
+
+namespace hangman {
+
+namespace {
+
+// ============ SHA-256 (FIPS 180-4) ============
+
+const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+inline uint32_t rotr(uint32_t x, unsigned n) { return (x >> n) | (x << (32 - n)); }
+
+struct Sha256 {
+    uint32_t state[8];
+    uint64_t length = 0;  // Bytes hashed so far
+    uint8_t block[64];
+    size_t used = 0;
+
+    Sha256() {
+        static const uint32_t IV[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                       0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+        memcpy(state, IV, sizeof(state));
+    }
+
+    void compress(const uint8_t* p) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = (uint32_t)p[4 * i] << 24 | (uint32_t)p[4 * i + 1] << 16 | (uint32_t)p[4 * i + 2] << 8 | p[4 * i + 3];
+        }
+        for (int i = 16; i < 64; ++i) {
+            uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+        uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+        uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+        for (int i = 0; i < 64; ++i) {
+            uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+            uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+        state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+
+    void update(const uint8_t* data, size_t len) {
+        length += len;
+        while (len > 0) {
+            size_t n = std::min(len, sizeof(block) - used);
+            memcpy(block + used, data, n);
+            used += n;
+            data += n;
+            len -= n;
+            if (used == sizeof(block)) {
+                compress(block);
+                used = 0;
+            }
+        }
+    }
+
+    void final(uint8_t out[32]) {
+        uint64_t bits = length * 8;
+        block[used++] = 0x80;
+        if (used > 56) {
+            memset(block + used, 0, sizeof(block) - used);
+            compress(block);
+            used = 0;
+        }
+        memset(block + used, 0, 56 - used);
+        for (int i = 0; i < 8; ++i) {
+            block[56 + i] = (uint8_t)(bits >> (56 - 8 * i));
+        }
+        compress(block);
+        for (int i = 0; i < 8; ++i) {
+            out[4 * i] = (uint8_t)(state[i] >> 24);
+            out[4 * i + 1] = (uint8_t)(state[i] >> 16);
+            out[4 * i + 2] = (uint8_t)(state[i] >> 8);
+            out[4 * i + 3] = (uint8_t)state[i];
+        }
+    }
+};
+
+// ============ HMAC-SHA256 ============
+
+// Inner/outer states after absorbing the padded key: each MAC of the PBKDF2
+// loop starts from a copy instead of rehashing the key
+struct HmacSha256 {
+    Sha256 inner;
+    Sha256 outer;
+
+    HmacSha256(const uint8_t* key, size_t keyLen) {
+        uint8_t k[64] = {0};
+        if (keyLen > sizeof(k)) {
+            Sha256 h;
+            h.update(key, keyLen);
+            h.final(k);
+        } else {
+            memcpy(k, key, keyLen);
+        }
+        uint8_t pad[64];
+        for (int i = 0; i < 64; ++i) pad[i] = k[i] ^ 0x36;
+        inner.update(pad, sizeof(pad));
+        for (int i = 0; i < 64; ++i) pad[i] = k[i] ^ 0x5c;
+        outer.update(pad, sizeof(pad));
+    }
+
+    void mac(const uint8_t* data, size_t len, uint8_t out[32]) const {
+        Sha256 in = inner;
+        in.update(data, len);
+        uint8_t digest[32];
+        in.final(digest);
+        Sha256 out2 = outer;
+        out2.update(digest, sizeof(digest));
+        out2.final(out);
+    }
+};
+
+std::string toHex(const uint8_t* data, size_t len) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out(len * 2, '0');
+    for (size_t i = 0; i < len; ++i) {
+        out[2 * i] = digits[data[i] >> 4];
+        out[2 * i + 1] = digits[data[i] & 0xF];
+    }
+    return out;
+}
+
+bool fromHex(const std::string& hex, std::vector<uint8_t>& out) {
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+    if (hex.size() % 2 != 0) {
+        return false;
+    }
+    out.resize(hex.size() / 2);
+    for (size_t i = 0; i < out.size(); ++i) {
+        int hi = nibble(hex[2 * i]);
+        int lo = nibble(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) {
+            return false;
+        }
+        out[i] = (uint8_t)(hi << 4 | lo);
+    }
+    return true;
+}
+
+// Runs over the whole input whatever the first mismatch
+bool constantTimeEquals(const uint8_t* a, const uint8_t* b, size_t len) {
+    uint8_t diff = 0;
+    for (size_t i = 0; i < len; ++i) {
+        diff |= a[i] ^ b[i];
+    }
+    return diff == 0;
+}
+
+const char PREFIX[] = "pbkdf2$";
+
+} // namespace
+
+void PasswordHash::pbkdf2(const std::string& password, const uint8_t* salt, size_t saltLen, uint32_t iterations,
+                          uint8_t out[HASH_SIZE]) {
+    HmacSha256 hmac((const uint8_t*)password.data(), password.size());
+
+    // Single output block: U1 = HMAC(P, salt || INT(1)), Ui = HMAC(P, Ui-1)
+    std::vector<uint8_t> first(salt, salt + saltLen);
+    first.insert(first.end(), {0, 0, 0, 1});
+    uint8_t u[HASH_SIZE];
+    hmac.mac(first.data(), first.size(), u);
+    memcpy(out, u, HASH_SIZE);
+    for (uint32_t i = 1; i < iterations; ++i) {
+        hmac.mac(u, HASH_SIZE, u);
+        for (size_t j = 0; j < HASH_SIZE; ++j) {
+            out[j] ^= u[j];
+        }
+    }
+}
+
+void PasswordHash::randomBytes(uint8_t* out, size_t len) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = getrandom(out + got, len - got, 0);
+        if (n > 0) {
+            got += (size_t)n;
+        } else if (n < 0 && errno != EINTR) {
+            break; // ENOSYS on old kernels: read the device instead
+        }
+    }
+    if (got == len) {
+        return;
+    }
+
+    int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+    while (fd >= 0 && got < len) {
+        ssize_t n = read(fd, out + got, len - got);
+        if (n > 0) {
+            got += (size_t)n;
+        } else if (n == 0 || errno != EINTR) {
+            break;
+        }
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (got < len) {
+        throw std::runtime_error("no system randomness available");
+    }
+}
+
+std::string PasswordHash::hash(const std::string& password, uint32_t iterations) {
+    if (iterations == 0) {
+        iterations = 1;
+    }
+    uint8_t salt[SALT_SIZE];
+    randomBytes(salt, SALT_SIZE);
+    uint8_t digest[HASH_SIZE];
+    pbkdf2(password, salt, SALT_SIZE, iterations, digest);
+    return PREFIX + std::to_string(iterations) + "$" + toHex(salt, SALT_SIZE) + "$" + toHex(digest, HASH_SIZE);
+}
+
+bool PasswordHash::selfTest() {
+    // PBKDF2-HMAC-SHA256 test vectors (RFC 7914 section 11 and the common
+    // "password"/"salt" set), first 32 bytes of the derived key; the last one
+    // has a password longer than the HMAC block, which is hashed first
+    struct Vector {
+        std::string password;
+        const char* salt;
+        uint32_t iterations;
+        const char* expected;
+    };
+    const Vector vectors[] = {
+        {"passwd", "salt", 1, "55ac046e56e3089fec1691c22544b605f94185216dde0465e68b9d57c20dacbc"},
+        {"password", "salt", 1, "120fb6cffcf8b32c43e7225256c4f837a86548c92ccc35480805987cb70be17b"},
+        {"password", "salt", 2, "ae4d0c95af6b46d32d0adff928f06dd02a303f8ef3c251dfd6e2d85a95474c43"},
+        {"password", "salt", 4096, "c5e478d59288c841aa530db6845c4c8d962893a001ce4e11a4963873aa98134a"},
+        {"passwordPASSWORDpassword", "saltSALTsaltSALTsaltSALTsaltSALTsalt", 4096,
+         "348c89dbcbd32b2f32d814b8116e84cf2b17347ebc1800181c4e2a1fb8dd53e1"},
+        {std::string(100, 'x'), "salt", 2, "d43a18cd77bafc1a4b0c6025dbbf29c7e6d67acce6ad02a736d4a3003b6a3c26"},
+    };
+    for (const Vector& v : vectors) {
+        uint8_t out[HASH_SIZE];
+        pbkdf2(v.password, (const uint8_t*)v.salt, strlen(v.salt), v.iterations, out);
+        if (toHex(out, HASH_SIZE) != v.expected) {
+            return false;
+        }
+    }
+
+    bool needsUpgrade;
+    std::string stored = hash("self-test", 2);
+    return verify("self-test", stored, needsUpgrade) && !needsUpgrade && !verify("self-tesT", stored, needsUpgrade);
+}
+
+bool PasswordHash::isLegacy(const std::string& stored) {
+    return stored.compare(0, sizeof(PREFIX) - 1, PREFIX) != 0;
+}
+
+bool PasswordHash::verify(const std::string& password, const std::string& stored, bool& needsUpgrade) {
+    needsUpgrade = false;
+    if (isLegacy(stored)) {
+        needsUpgrade = true;
+        return password.size() == stored.size() &&
+               constantTimeEquals((const uint8_t*)password.data(), (const uint8_t*)stored.data(), stored.size());
+    }
+
+    // pbkdf2$<iterations>$<salt>$<hash>
+    size_t iterEnd = stored.find('$', sizeof(PREFIX) - 1);
+    size_t saltEnd = iterEnd == std::string::npos ? std::string::npos : stored.find('$', iterEnd + 1);
+    if (saltEnd == std::string::npos) {
+        return false;
+    }
+    uint32_t iterations = 0;
+    try {
+        iterations = (uint32_t)std::stoul(stored.substr(sizeof(PREFIX) - 1, iterEnd - (sizeof(PREFIX) - 1)));
+    } catch (...) {
+        return false;
+    }
+    std::vector<uint8_t> salt, expected;
+    if (iterations == 0 || !fromHex(stored.substr(iterEnd + 1, saltEnd - iterEnd - 1), salt) ||
+        !fromHex(stored.substr(saltEnd + 1), expected) || expected.size() != HASH_SIZE) {
+        return false;
+    }
+    uint8_t digest[HASH_SIZE];
+    pbkdf2(password, salt.data(), salt.size(), iterations, digest);
+    return constantTimeEquals(digest, expected.data(), HASH_SIZE);
+}
+
+} // namespace hangman
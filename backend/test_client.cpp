@@ -168,7 +168,12 @@ int main(int argc, char* argv[]) {
                     sessionToken = result.session_token;
                     std::cout << "  Result: code=" << resultCodeToString(result.code) 
                               << " message=" << result.message << std::endl;
-                    std::cout << "  Session token: " << sessionToken << std::endl;
+                    std::cout << "  Session token: ";
+                    for (unsigned char c : sessionToken) {
+                        static const char hex[] = "0123456789abcdef";
+                        std::cout << hex[c >> 4] << hex[c & 0xF];
+                    }
+                    std::cout << " (" << sessionToken.size() << " bytes)" << std::endl;
                     std::cout << "  Wins: " << result.num_of_wins << ", Points: " << result.total_points << std::endl;
                     if (result.code == ResultCode::SUCCESS && !sessionToken.empty()) 
                         std::cout << "  ✓ PASS" << std::endl;
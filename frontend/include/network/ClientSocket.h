@@ -17,6 +17,9 @@ public:
 
     bool connect(const std::string& host, int port);
     void disconnect();
+
+    // Wake a thread blocked in receive (the fd stays open until disconnect)
+    void shutdown();
     bool isConnected() const { return sockfd >= 0; }
 
     // Send raw data
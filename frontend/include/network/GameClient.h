@@ -2,9 +2,15 @@
 
 #include "network/ClientSocket.h"
 #include "protocol/packets.h"
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
 #include <memory>
 #include <string>
 #include <mutex>
+#include <thread>
 
 namespace hangman {
 
@@ -15,35 +21,139 @@ public:
     GameClient(const GameClient&) = delete;
     GameClient& operator=(const GameClient&) = delete;
 
+    // A packet as received from the server
+    struct Packet {
+        uint16_t type = 0;
+        std::vector<uint8_t> payload;
+    };
+
     // Connection
     bool connect(const std::string& host = "127.0.0.1", int port = 5000);
     void disconnect();
     bool isConnected() const;
 
-    // Authentication
+    // Asynchronous requests: any number may be in flight. Requests go out
+    // with a v2 header whose request id the server echoes, so replies are
+    // matched by id in whatever order they come. Each future gets the reply
+    // of its request; it throws std::runtime_error on S2C_Error, if the
+    // connection drops first or if no reply came within REQUEST_TIMEOUT.
+    std::future<S2C_RegisterResult> registerUserAsync(const std::string& username, const std::string& password);
+    std::future<S2C_LoginResult> loginAsync(const std::string& username, const std::string& password);
+    std::future<S2C_LogoutAck> logoutAsync();
+    std::future<S2C_CreateRoomResult> createRoomAsync(const std::string& roomName);
+    std::future<S2C_LeaveRoomAck> leaveRoomAsync(uint32_t roomId);
+
+    // Answer an invite. Accepting joins the inviter's room and the future
+    // gets that result; a decline has no reply, its future is ready at once.
+    std::future<S2C_CreateRoomResult> respondInviteAsync(const std::string& fromUsername, bool accept);
+
+    // Authentication (blocking: failures come back as a non-SUCCESS code)
     S2C_RegisterResult registerUser(const std::string& username, const std::string& password);
     S2C_LoginResult login(const std::string& username, const std::string& password);
     S2C_LogoutAck logout();
 
-    // Room Management
+    // Room Management (blocking)
     S2C_CreateRoomResult createRoom(const std::string& roomName);
     S2C_LeaveRoomAck leaveRoom(uint32_t roomId);
+    S2C_CreateRoomResult respondInvite(const std::string& fromUsername, bool accept);
+
+    // Reconnect after a dropped connection and resume the session with its
+    // token (no password). Requests do this by themselves when the link drops.
+    bool reconnect();
+
+    // Server pushes (invites, players leaving, ...) that answer no request,
+    // in arrival order. Without a callback they are queued for polling; a
+    // callback runs on the receive thread instead.
+    bool pollNotification(Packet& out);
+    void setNotificationCallback(std::function<void(const Packet&)> callback);
+
+    // eventfd that becomes readable when a notification is queued or the
+    // connection drops, for a poll()-based UI loop. Reading it resets it.
+    int getNotificationFd() const { return notifyFd; }
 
     // Get current session token
-    const std::string& getSessionToken() const { return sessionToken; }
-    bool hasValidSession() const { return !sessionToken.empty(); }
+    std::string getSessionToken() const;
+    bool hasValidSession() const;
+
+    // Requests fail after this long without a reply
+    static constexpr std::chrono::seconds REQUEST_TIMEOUT{10};
 
 private:
     GameClient();
-    ~GameClient() = default;
+    ~GameClient();
+
+    // Reply handler of a request in flight: complete(reply, nullptr), or
+    // complete(nullptr, reason) if it failed (connection lost, timed out)
+    struct PendingRequest {
+        uint32_t id = 0;
+        uint16_t requestType = 0;
+        uint16_t responseType = 0;
+        std::chrono::steady_clock::time_point deadline;
+        std::function<void(const Packet*, const char*)> complete;
+    };
+
+    // Queue the reply handler, then send (the reply cannot overtake it).
+    // onResponse runs on the receive thread before the future is ready.
+    template<typename ResponseType>
+    std::future<ResponseType> request(const std::vector<uint8_t>& packet, PacketType responseType,
+                                      std::function<void(const ResponseType&)> onResponse = nullptr);
+    template<typename ResponseType>
+    std::future<ResponseType> requestLocked(const std::vector<uint8_t>& packet, PacketType responseType,
+                                            std::function<void(const ResponseType&)> onResponse, bool resume);
 
-    // Send packet and receive response
+    // Send with entry queued (sendMutex held). On failure the entry is taken
+    // back; its complete is cleared if the receive thread already failed it.
+    bool sendLocked(const std::vector<uint8_t>& packet, PendingRequest& entry);
+
+    // Send a request that gets no reply
+    bool post(const std::vector<uint8_t>& packet);
+
+    // Wait for a blocking call's reply
     template<typename ResponseType>
-    ResponseType sendAndReceive(const std::vector<uint8_t>& packet);
+    ResponseType await(std::future<ResponseType> future);
+
+    // Receive thread: v2 replies go to the request with their id, pushes
+    // carry id 0. v1 packets go to the oldest request expecting their type
+    // (S2C_Error to the oldest request of its for_type), others are pushes.
+    void readerLoop();
+    void dispatchPacket(Packet& packet, uint8_t version, uint32_t requestId);
+    void failPending();
+
+    // Fail requests past their deadline, so a late reply cannot complete a
+    // stale entry (v1 replies are matched by type) and entries do not pile up
+    void expirePending();
+
+    // Stop the receive thread and close the socket (sendMutex held)
+    void closeLocked();
+
+    // New connection + C2S_ResumeSession (sendMutex held)
+    bool reconnectLocked();
+
+    // Token for outgoing requests: empty once the server has bound the
+    // session to this connection (after login), so it is not resent
+    std::string requestToken() const;
 
     std::unique_ptr<ClientSocket> socket;
+    std::string serverHost;
+    int serverPort = 0;
+    std::mutex sendMutex; // Sending, connect/reconnect
+
+    std::thread readerThread;
+    std::atomic<bool> readerRunning{false};
+
+    std::deque<PendingRequest> pending; // Oldest first
+    uint32_t nextRequestId = 1;
+    std::mutex pendingMutex;
+
+    std::deque<Packet> notifications;
+    std::function<void(const Packet&)> notificationCallback;
+    std::mutex notificationMutex;
+    int notifyFd = -1;
+
+    // Written by the receive thread when login/logout replies arrive
     std::string sessionToken;
-    std::mutex socketMutex;
+    bool sessionBound = false;
+    mutable std::mutex sessionMutex;
 };
 
 } // namespace hangman
@@ -22,6 +22,7 @@ public:
     void write_u8(uint8_t v) { buf.push_back(v); }
     void write_u16(uint16_t v) { uint16_t x = htons(v); append_bytes(&x, sizeof(x)); }
     void write_u32(uint32_t v) { uint32_t x = htonl(v); append_bytes(&x, sizeof(x)); }
+    void write_u64(uint64_t v) { write_u32((uint32_t)(v >> 32)); write_u32((uint32_t)v); }
     void write_bytes(const uint8_t* data, size_t len) { append_bytes(data, len); }
     void write_string(const std::string& s) {
         // write length (u16) then bytes
@@ -49,6 +50,10 @@ public:
         rpos += 4;
         return ntohl(x);
     }
+    uint64_t read_u64() {
+        uint64_t hi = read_u32();
+        return (hi << 32) | read_u32();
+    }
     std::string read_string() {
         uint16_t len = read_u16();
         require(len);
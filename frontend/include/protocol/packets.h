@@ -13,8 +13,28 @@ struct PacketHeader {
     uint8_t version;
     PacketType type;
     uint32_t payload_len;
+    uint32_t request_id = 0; // v2 only
 
     static constexpr size_t HEADER_SIZE = 1 + 2 + 4;
+    static constexpr size_t HEADER_SIZE_V2 = HEADER_SIZE + 4;
+
+    static constexpr size_t header_size(uint8_t version) {
+        return version == PROTOCOL_VERSION_V2 ? HEADER_SIZE_V2 : HEADER_SIZE;
+    }
+
+    // Write a v2 header into out (HEADER_SIZE_V2 bytes)
+    static void write_header_v2(uint8_t* out, uint16_t type, uint32_t payload_len, uint32_t request_id) {
+        out[0] = PROTOCOL_VERSION_V2;
+        out[1] = (uint8_t)(type >> 8);
+        out[2] = (uint8_t)type;
+        for (int i = 0; i < 4; ++i) {
+            out[3 + i] = (uint8_t)(payload_len >> (24 - 8 * i));
+            out[7 + i] = (uint8_t)(request_id >> (24 - 8 * i));
+        }
+    }
+
+    // Re-frame a packet built by to_bytes() (v1 header) as v2
+    static std::vector<uint8_t> to_v2(const std::vector<uint8_t>& packet, uint32_t request_id);
 
     // serialize header (not payload)
     static std::vector<uint8_t> encode_header(uint8_t version, PacketType type, uint32_t payload_len) {
@@ -79,6 +99,24 @@ struct S2C_LogoutAck {
     static S2C_LogoutAck from_payload(ByteBuffer& bb);
 };
 
+// Reconnect with the token of a session whose connection dropped
+struct C2S_ResumeSession {
+    std::string session_token;
+    std::vector<uint8_t> to_bytes() const;
+    static C2S_ResumeSession from_payload(ByteBuffer& bb);
+};
+
+// Followed by the notifications queued while the client was away
+struct S2C_ResumeResult {
+    ResultCode code;
+    std::string message;
+    std::string username; // if OK
+    uint16_t num_of_wins;
+    uint16_t total_points;
+    std::vector<uint8_t> to_bytes() const;
+    static S2C_ResumeResult from_payload(ByteBuffer& bb);
+};
+
 // Lobby
 struct C2S_CreateRoom {
     std::string session_token;
@@ -0,0 +1,40 @@
+#ifndef CLIENT_EVENT_LOOP_H
+#define CLIENT_EVENT_LOOP_H
+
+#include <ncurses.h>
+#include <deque>
+#include "network/GameClient.h"
+
+// Client loop: waits on stdin and the GameClient notification fd together
+// with poll(), so server pushes (invites, opponent moves) reach the active
+// screen as soon as they arrive instead of after the next keypress.
+// Nothing spins: between events the process sleeps in poll().
+class ClientEventLoop {
+public:
+    enum class EventType {
+        KEY,          // key: a key from the terminal
+        PACKET,       // packet: a server push
+        DISCONNECTED, // the connection dropped (reported once per drop)
+        TICK          // timeout passed with nothing to do
+    };
+
+    struct Event {
+        EventType type = EventType::TICK;
+        int key = ERR;
+        hangman::GameClient::Packet packet;
+    };
+
+    // Next event for the screen reading keys from win (keypad mode of win
+    // applies). timeoutMs < 0 waits until something happens.
+    Event wait(WINDOW* win, int timeoutMs = -1);
+
+private:
+    // Move pending keys and pushes into events
+    void drain(WINDOW* win);
+
+    std::deque<Event> events;
+    bool stdinOpen = true;
+    bool dropReported = false;
+};
+
+#endif // CLIENT_EVENT_LOOP_H
@@ -35,6 +35,8 @@ public:
     void hide();
     void draw();
     int handleInput();  // Returns: 1=yes, -1=no, 0=continue
+    int handleKey(int ch);  // Same, for a key read by the caller
+    WINDOW* getWindow() const { return dialogWin; }
     
     bool active() const { return isActive; }
 };
@@ -36,9 +36,12 @@ public:
     void hide();
     void draw();
     int handleInput();  // Returns: 1=accept, -1=decline, 0=continue
+    int handleKey(int ch);  // Same, for a key read by the caller
+    WINDOW* getWindow() const { return overlayWin; }
     
     void setCountdown(int seconds);
     bool active() const { return isActive; }
+    std::string getFromUsername() const { return fromUsername; }
 };
 
 #endif // INVITE_NOTIFICATION_H
\ No newline at end of file
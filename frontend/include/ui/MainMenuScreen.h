@@ -3,6 +3,7 @@
 
 #include <ncurses.h>
 #include <string>
+#include "ui/RenderLayer.h"
 
 enum class MenuOption {
     CREATE_ROOM,
@@ -24,16 +25,27 @@ private:
     int userLevel;
     int userWins;
     int userLosses;
+    bool connected = true;
+    
+    // Retained rendering: navigation only redraws the menu
+    RenderLayer layer;
+    RenderLayer infoLayer;
+    int menuRegion;
+    int linkRegion;
     
     // UI Constants
     static const int MENU_START_Y = 12;
+    static const int MENU_CENTER_X = 40;
+    static const int MENU_ITEM_WIDTH = 36;  // " > %-30s < "
     static const int INFO_BOX_HEIGHT = 8;
     static const int INFO_BOX_WIDTH = 40;
+    static const int LINK_STATE_WIDTH = 13;  // "[ OFFLINE ]" on the info box's bottom border
     
     // Private methods
     void drawBorder();
     void drawTitle();
     void drawUserInfo();
+    void drawLinkState();
     void drawMenu();
     void drawInstructions();
     void drawDecoration();
@@ -44,10 +56,14 @@ public:
     MainMenuScreen();
     ~MainMenuScreen();
     
-    void draw();
+    void draw();        // Redraws only what changed since the last draw
+    void invalidate();  // Screen was covered: show it in full on the next draw
     int handleInput();  // Returns: 1=create room, 2=history, 3=rankings, -1=logout, -2=quit
+    int handleKey(int ch);  // Same, for a key read by the caller
+    WINDOW* getWindow() const { return mainWin; }
     
     void setUserInfo(const std::string& name, int level = 1, int wins = 0, int losses = 0);
+    void setConnected(bool isConnected);  // Link state shown in the info box
     std::string getUsername() const { return username; }
 };
 
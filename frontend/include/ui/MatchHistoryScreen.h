@@ -5,6 +5,7 @@
 #include <string>
 #include <vector>
 #include <ctime>
+#include "ui/RenderLayer.h"
 
 struct MatchRecord {
     uint32_t match_id;
@@ -30,6 +31,12 @@ private:
     int scrollOffset;
     bool showDetail;
     
+    // Retained rendering: navigation only redraws the list, details and footer
+    RenderLayer layer;
+    int listRegion;
+    int detailRegion;
+    int footerRegion;
+    
     // UI Constants
     static const int LIST_START_Y = 10;
     static const int LIST_HEIGHT = 15;
@@ -53,8 +60,11 @@ public:
     MatchHistoryScreen();
     ~MatchHistoryScreen();
     
-    void draw();
+    void draw();        // Redraws only what changed since the last draw
+    void invalidate();  // Screen was covered: show it in full on the next draw
     int handleInput();  // Returns: -1=back to menu, 0=continue
+    int handleKey(int ch);  // Same, for a key read by the caller
+    WINDOW* getWindow() const { return mainWin; }
     
     void setMatches(const std::vector<MatchRecord>& matchList);
     void reset();
@@ -58,6 +58,8 @@ public:
     
     void draw();
     int handleInput();  // Returns: -1=back, 1=send invite, 2=invite accepted, 3=invite declined
+    int handleKey(int ch);  // Same, for a key read by the caller
+    WINDOW* getWindow() const { return mainWin; }
     
     void setPlayers(const std::vector<OnlinePlayer>& playerList);
     void setCurrentUser(const std::string& username);
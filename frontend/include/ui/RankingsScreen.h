@@ -4,6 +4,7 @@
 #include <ncurses.h>
 #include <string>
 #include <vector>
+#include "ui/RenderLayer.h"
 
 struct PlayerRanking {
     std::string username;
@@ -32,6 +33,11 @@ private:
     int scrollOffset;
     std::string currentUser;  // To highlight current user
     
+    // Retained rendering: navigation only redraws the list and footer
+    RenderLayer layer;
+    int listRegion;
+    int footerRegion;
+    
     // UI Constants
     static const int LIST_START_Y = 11;
     static const int LIST_HEIGHT = 15;
@@ -52,8 +58,11 @@ public:
     RankingsScreen();
     ~RankingsScreen();
     
-    void draw();
+    void draw();        // Redraws only what changed since the last draw
+    void invalidate();  // Screen was covered: show it in full on the next draw
     int handleInput();  // Returns: -1=back to menu, 0=continue
+    int handleKey(int ch);  // Same, for a key read by the caller
+    WINDOW* getWindow() const { return mainWin; }
     
     void setRankings(const std::vector<PlayerRanking>& rankList);
     void setCurrentUser(const std::string& username);
@@ -0,0 +1,55 @@
+#ifndef RENDER_LAYER_H
+#define RENDER_LAYER_H
+
+#include <ncurses.h>
+#include <functional>
+#include <vector>
+
+// Retained-mode rendering for one window. A screen registers its parts as
+// regions: static ones (border, ASCII-art title) are drawn only on a full
+// repaint, dynamic ones (list, menu, status line) own a rectangle and are
+// redrawn only after invalidate() - their rectangle is blanked and drawn
+// again, every other cell stays as it is. render() stages the window with
+// wnoutrefresh(); the frame goes out with one doupdate(), and ncurses sends
+// the terminal only the cells that actually changed.
+class RenderLayer {
+public:
+    RenderLayer() = default;
+    explicit RenderLayer(WINDOW* win) : win(win) {}
+
+    void setWindow(WINDOW* w) { win = w; eraseAll = true; }
+
+    // Drawn on full repaints only
+    void addStatic(std::function<void()> draw);
+
+    // Drawn inside the rectangle (window coordinates); returns its id
+    int addRegion(int y, int x, int h, int w, std::function<void()> draw);
+
+    void invalidate(int region);
+
+    // New data: erase the window and draw every region again
+    void invalidateAll();
+
+    // Contents unchanged but something else was drawn over the window:
+    // stage it again on the next render(), without redrawing any region
+    void touch();
+
+    // Redraw what is dirty and stage the window; false if nothing to do
+    bool render();
+
+private:
+    struct Region {
+        int y, x, h, w;           // h == 0: static
+        std::function<void()> draw;
+        bool dirty;
+    };
+
+    void clearRect(const Region& region);
+
+    WINDOW* win = nullptr;
+    std::vector<Region> regions;
+    bool eraseAll = true;
+    bool touched = false;
+};
+
+#endif // RENDER_LAYER_H
@@ -58,6 +58,8 @@ public:
     
     void draw();
     int handleInput();  // Returns: 1=ready, 2=leave, 3=kick, 4=start game
+    int handleKey(int ch);  // Same, for a key read by the caller
+    WINDOW* getWindow() const { return mainWin; }
     
     void setRoomId(uint32_t id) { roomId = id; }
     void setPlayers(const PlayerInfo& p1, const PlayerInfo& p2);
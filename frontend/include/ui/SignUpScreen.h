@@ -3,6 +3,7 @@
 
 #include <ncurses.h>
 #include <string>
+#include "ui/RenderLayer.h"
 
 enum class SignUpOption {
     SIGNUP,
@@ -30,6 +31,12 @@ private:
     std::string errorMessage;
     std::string successMessage;
     
+    // Retained rendering: keys only redraw fields, menu and messages
+    RenderLayer layer;
+    int fieldsRegion;
+    int menuRegion;
+    int messageRegion;
+    
     // UI Constants
     static const int MENU_START_Y = 18;
     static const int INPUT_WIDTH = 30;
@@ -44,6 +51,7 @@ private:
     
     void handleMenuNavigation(int ch);
     void handleFieldInput(int ch);
+    void markDirty();  // Fields, menu and message need a redraw
     void switchToField(SignUpField field);
     
     bool validateInput();
@@ -52,8 +60,11 @@ public:
     SignUpScreen();
     ~SignUpScreen();
     
-    void draw();
+    void draw();        // Redraws only what changed since the last draw
+    void invalidate();  // Screen was covered: show it in full on the next draw
     int handleInput();  // Returns: 0=continue, 1=signup success, -1=back to login
+    int handleKey(int ch);  // Same, for a key read by the caller
+    WINDOW* getWindow() const { return mainWin; }
     
     std::string getUsername() const { return username; }
     std::string getPassword() const { return password; }
@@ -47,12 +47,19 @@ void ClientSocket::disconnect() {
     }
 }
 
+void ClientSocket::shutdown() {
+    if (sockfd >= 0) {
+        ::shutdown(sockfd, SHUT_RDWR);
+    }
+}
+
 bool ClientSocket::send(const uint8_t* data, size_t len) {
     if (sockfd < 0) return false;
 
     size_t totalSent = 0;
     while (totalSent < len) {
-        ssize_t sent = ::send(sockfd, data + totalSent, len - totalSent, 0);
+        // No SIGPIPE on a dropped link: report it so the caller can reconnect
+        ssize_t sent = ::send(sockfd, data + totalSent, len - totalSent, MSG_NOSIGNAL);
         if (sent <= 0) {
             std::cerr << "Send failed" << std::endl;
             return false;
@@ -1,6 +1,9 @@
 #include "network/GameClient.h"
 #include "protocol/bytebuffer.h"
 #include <iostream>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 namespace hangman {
 
@@ -13,123 +16,449 @@ GameClient& GameClient::getInstance() {
     return *g_gameClient;
 }
 
-GameClient::GameClient() : socket(std::make_unique<ClientSocket>()) {}
+GameClient::GameClient() : socket(std::make_unique<ClientSocket>()) {
+    notifyFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (notifyFd < 0) {
+        throw std::runtime_error("Failed to create eventfd");
+    }
+}
+
+GameClient::~GameClient() {
+    if (notifyFd >= 0) {
+        ::close(notifyFd);
+    }
+}
+
+// Blocking calls report a failed or lost request like a server-side failure
+template<typename ResponseType>
+static ResponseType failedResponse(const std::string& message) {
+    ResponseType response{};
+    response.code = ResultCode::SERVER_ERROR;
+    response.message = message;
+    return response;
+}
 
 bool GameClient::connect(const std::string& host, int port) {
-    std::lock_guard<std::mutex> lock(socketMutex);
-    return socket->connect(host, port);
+    std::lock_guard<std::mutex> lock(sendMutex);
+    closeLocked();
+    serverHost = host;
+    serverPort = port;
+    if (!socket->connect(host, port)) {
+        return false;
+    }
+    readerRunning = true;
+    readerThread = std::thread(&GameClient::readerLoop, this);
+    return true;
 }
 
 void GameClient::disconnect() {
-    std::lock_guard<std::mutex> lock(socketMutex);
+    std::lock_guard<std::mutex> lock(sendMutex);
+    closeLocked();
+    serverPort = 0; // No automatic reconnect after this
+    std::lock_guard<std::mutex> sessionLock(sessionMutex);
     sessionToken.clear();
-    socket->disconnect();
+    sessionBound = false;
 }
 
 bool GameClient::isConnected() const {
-    return socket->isConnected();
+    return readerRunning;
+}
+
+void GameClient::closeLocked() {
+    socket->shutdown();
+    if (readerThread.joinable()) {
+        readerThread.join(); // Fails whatever is still pending
+    }
+    socket->disconnect();
+}
+
+bool GameClient::reconnect() {
+    std::lock_guard<std::mutex> lock(sendMutex);
+    return reconnectLocked();
+}
+
+bool GameClient::reconnectLocked() {
+    closeLocked();
+    std::string token;
+    {
+        std::lock_guard<std::mutex> sessionLock(sessionMutex);
+        sessionBound = false;
+        token = sessionToken;
+    }
+    if (serverPort == 0 || !socket->connect(serverHost, serverPort)) {
+        return false;
+    }
+    readerRunning = true;
+    readerThread = std::thread(&GameClient::readerLoop, this);
+    if (token.empty()) {
+        return true; // No session to pick up
+    }
+
+    C2S_ResumeSession resumeReq;
+    resumeReq.session_token = token;
+    auto future = requestLocked<S2C_ResumeResult>(
+        resumeReq.to_bytes(), PacketType::S2C_ResumeResult,
+        [this](const S2C_ResumeResult& result) {
+            std::lock_guard<std::mutex> sessionLock(sessionMutex);
+            if (result.code == ResultCode::SUCCESS) {
+                sessionBound = true;
+            } else {
+                sessionToken.clear(); // Session expired on the server: a full login is needed
+            }
+        },
+        false);
+    return await(std::move(future)).code == ResultCode::SUCCESS;
 }
 
 template<typename ResponseType>
-ResponseType GameClient::sendAndReceive(const std::vector<uint8_t>& packet) {
-    std::lock_guard<std::mutex> lock(socketMutex);
-    
-    ResponseType response;
-    
-    // Send packet
-    if (!socket->send(packet)) {
-        std::cerr << "Failed to send packet" << std::endl;
-        return response;
-    }
-
-    // Receive header (7 bytes)
-    std::vector<uint8_t> headerData;
-    if (!socket->receive(headerData, 7)) {
-        std::cerr << "Failed to receive header" << std::endl;
-        return response;
-    }
-
-    ByteBuffer headerBuf;
-    headerBuf.buf = headerData;
-    
-    uint8_t version = headerBuf.read_u8();
-    uint16_t packetType = headerBuf.read_u16();
-    uint32_t payloadLen = headerBuf.read_u32();
-
-    (void)version;
-    (void)packetType;
-
-    // Receive payload
-    std::vector<uint8_t> payloadData;
-    if (payloadLen > 0) {
-        if (!socket->receive(payloadData, payloadLen)) {
-            std::cerr << "Failed to receive payload" << std::endl;
-            return response;
+std::future<ResponseType> GameClient::request(const std::vector<uint8_t>& packet, PacketType responseType,
+                                              std::function<void(const ResponseType&)> onResponse) {
+    std::lock_guard<std::mutex> lock(sendMutex);
+    return requestLocked<ResponseType>(packet, responseType, std::move(onResponse), true);
+}
+
+template<typename ResponseType>
+std::future<ResponseType> GameClient::requestLocked(const std::vector<uint8_t>& packet, PacketType responseType,
+                                                    std::function<void(const ResponseType&)> onResponse,
+                                                    bool resume) {
+    auto promise = std::make_shared<std::promise<ResponseType>>();
+    std::future<ResponseType> future = promise->get_future();
+
+    PendingRequest entry;
+    // Outgoing packet type from the header (u8 version, u16 type)
+    entry.requestType = packet.size() >= 3 ? (uint16_t)((packet[1] << 8) | packet[2]) : 0;
+    entry.responseType = static_cast<uint16_t>(responseType);
+    entry.complete = [promise, onResponse](const Packet* reply, const char* failure) {
+        if (!reply) {
+            promise->set_exception(std::make_exception_ptr(std::runtime_error(failure)));
+            return;
+        }
+        try {
+            ByteBuffer payloadBuf;
+            payloadBuf.buf = reply->payload;
+            if (reply->type == static_cast<uint16_t>(PacketType::S2C_Error)) {
+                throw std::runtime_error(S2C_Error::from_payload(payloadBuf).message);
+            }
+            ResponseType response = ResponseType::from_payload(payloadBuf);
+            if (onResponse) {
+                onResponse(response);
+            }
+            promise->set_value(std::move(response));
+        } catch (...) {
+            promise->set_exception(std::current_exception());
+        }
+    };
+
+    // A dropped link is resumed and the request sent once more (it never
+    // reached the server)
+    bool sent = readerRunning && sendLocked(packet, entry);
+    if (!sent && entry.complete && resume && reconnectLocked()) {
+        sent = sendLocked(packet, entry);
+    }
+    if (!sent && entry.complete) {
+        entry.complete(nullptr, "Connection lost");
+    }
+    return future;
+}
+
+bool GameClient::sendLocked(const std::vector<uint8_t>& packet, PendingRequest& entry) {
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        entry.id = nextRequestId++;
+        if (nextRequestId == 0) {
+            nextRequestId = 1; // 0 marks pushes
+        }
+        entry.deadline = std::chrono::steady_clock::now() + REQUEST_TIMEOUT;
+        pending.push_back(entry);
+    }
+    if (socket->send(PacketHeader::to_v2(packet, entry.id))) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(pendingMutex);
+    for (auto it = pending.begin(); it != pending.end(); ++it) {
+        if (it->id == entry.id) {
+            pending.erase(it);
+            return false;
+        }
+    }
+    entry.complete = nullptr; // Already failed by the receive thread
+    return false;
+}
+
+bool GameClient::post(const std::vector<uint8_t>& packet) {
+    std::lock_guard<std::mutex> lock(sendMutex);
+    uint32_t id;
+    {
+        std::lock_guard<std::mutex> pendingLock(pendingMutex);
+        id = nextRequestId++;
+        if (nextRequestId == 0) {
+            nextRequestId = 1;
         }
     }
+    return readerRunning && socket->send(PacketHeader::to_v2(packet, id));
+}
 
-    // Parse response
-    ByteBuffer payloadBuf;
-    payloadBuf.buf = payloadData;
-    
+template<typename ResponseType>
+ResponseType GameClient::await(std::future<ResponseType> future) {
+    if (future.wait_for(REQUEST_TIMEOUT) != std::future_status::ready) {
+        // Take the request out of pending (its future fails with a timeout)
+        expirePending();
+        if (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            std::cerr << "Request timed out" << std::endl;
+            return failedResponse<ResponseType>("Request timed out");
+        }
+    }
     try {
-        response = ResponseType::from_payload(payloadBuf);
+        return future.get();
     } catch (const std::exception& e) {
-        std::cerr << "Failed to parse response: " << e.what() << std::endl;
+        std::cerr << "Request failed: " << e.what() << std::endl;
+        return failedResponse<ResponseType>(e.what());
     }
+}
 
-    return response;
+void GameClient::readerLoop() {
+    while (true) {
+        // Receive header (7 bytes)
+        std::vector<uint8_t> headerData;
+        if (!socket->receive(headerData, 7)) {
+            break;
+        }
+
+        ByteBuffer headerBuf;
+        headerBuf.buf = headerData;
+
+        uint8_t version = headerBuf.read_u8();
+        Packet packet;
+        packet.type = headerBuf.read_u16();
+        uint32_t payloadLen = headerBuf.read_u32();
+
+        // v2: request id follows
+        uint32_t requestId = 0;
+        if (version == PROTOCOL_VERSION_V2) {
+            std::vector<uint8_t> idData;
+            if (!socket->receive(idData, 4)) {
+                break;
+            }
+            ByteBuffer idBuf;
+            idBuf.buf = idData;
+            requestId = idBuf.read_u32();
+        }
+
+        // Receive payload
+        if (payloadLen > 0 && !socket->receive(packet.payload, payloadLen)) {
+            break;
+        }
+        dispatchPacket(packet, version, requestId);
+    }
+    readerRunning = false;
+    failPending();
+
+    uint64_t value = 1;
+    (void)write(notifyFd, &value, sizeof(value));
 }
 
-S2C_RegisterResult GameClient::registerUser(const std::string& username, const std::string& password) {
+void GameClient::dispatchPacket(Packet& packet, uint8_t version, uint32_t requestId) {
+    // v1 errors name the request type they answer
+    bool byId = version == PROTOCOL_VERSION_V2;
+    bool isError = packet.type == static_cast<uint16_t>(PacketType::S2C_Error);
+    uint16_t forType = 0;
+    if (!byId && isError) {
+        try {
+            ByteBuffer payloadBuf;
+            payloadBuf.buf = packet.payload;
+            forType = S2C_Error::from_payload(payloadBuf).for_type;
+        } catch (const std::exception&) {
+            forType = 0;
+        }
+    }
+
+    expirePending();
+
+    std::function<void(const Packet*, const char*)> complete;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        for (auto it = pending.begin(); it != pending.end(); ++it) {
+            bool matches = byId ? it->id == requestId
+                                : (isError ? it->requestType == forType : it->responseType == packet.type);
+            if (matches) {
+                complete = std::move(it->complete);
+                pending.erase(it);
+                break;
+            }
+        }
+    }
+    if (complete) {
+        complete(&packet, nullptr);
+        return;
+    }
+
+    // Not a reply: server push
+    std::function<void(const Packet&)> callback;
+    {
+        std::lock_guard<std::mutex> lock(notificationMutex);
+        if (!notificationCallback) {
+            notifications.push_back(std::move(packet));
+            uint64_t value = 1;
+            (void)write(notifyFd, &value, sizeof(value));
+            return;
+        }
+        callback = notificationCallback;
+    }
+    callback(packet);
+}
+
+void GameClient::failPending() {
+    std::deque<PendingRequest> failed;
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        failed.swap(pending);
+    }
+    for (PendingRequest& entry : failed) {
+        entry.complete(nullptr, "Connection lost");
+    }
+}
+
+void GameClient::expirePending() {
+    auto now = std::chrono::steady_clock::now();
+    std::deque<PendingRequest> expired;
+    {
+        // Deadlines are set in send order: the expired ones are at the front
+        std::lock_guard<std::mutex> lock(pendingMutex);
+        while (!pending.empty() && pending.front().deadline <= now) {
+            expired.push_back(std::move(pending.front()));
+            pending.pop_front();
+        }
+    }
+    for (PendingRequest& entry : expired) {
+        entry.complete(nullptr, "Request timed out");
+    }
+}
+
+bool GameClient::pollNotification(Packet& out) {
+    std::lock_guard<std::mutex> lock(notificationMutex);
+    if (notifications.empty()) {
+        return false;
+    }
+    out = std::move(notifications.front());
+    notifications.pop_front();
+    return true;
+}
+
+void GameClient::setNotificationCallback(std::function<void(const Packet&)> callback) {
+    std::lock_guard<std::mutex> lock(notificationMutex);
+    notificationCallback = std::move(callback);
+}
+
+std::string GameClient::getSessionToken() const {
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    return sessionToken;
+}
+
+bool GameClient::hasValidSession() const {
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    return !sessionToken.empty();
+}
+
+std::string GameClient::requestToken() const {
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    return sessionBound ? std::string() : sessionToken;
+}
+
+std::future<S2C_RegisterResult> GameClient::registerUserAsync(const std::string& username,
+                                                              const std::string& password) {
     C2S_Register request;
     request.username = username;
     request.password = password;
-    
-    return sendAndReceive<S2C_RegisterResult>(request.to_bytes());
+
+    return this->request<S2C_RegisterResult>(request.to_bytes(), PacketType::S2C_RegisterResult);
 }
 
-S2C_LoginResult GameClient::login(const std::string& username, const std::string& password) {
+std::future<S2C_LoginResult> GameClient::loginAsync(const std::string& username, const std::string& password) {
     C2S_Login request;
     request.username = username;
     request.password = password;
-    
-    auto response = sendAndReceive<S2C_LoginResult>(request.to_bytes());
-    
-    if (response.code == ResultCode::SUCCESS) {
-        sessionToken = response.session_token;
-    }
-    
-    return response;
+
+    return this->request<S2C_LoginResult>(request.to_bytes(), PacketType::S2C_LoginResult,
+                                          [this](const S2C_LoginResult& response) {
+                                              if (response.code == ResultCode::SUCCESS) {
+                                                  std::lock_guard<std::mutex> lock(sessionMutex);
+                                                  sessionToken = response.session_token;
+                                                  sessionBound = true;
+                                              }
+                                          });
 }
 
-S2C_LogoutAck GameClient::logout() {
+std::future<S2C_LogoutAck> GameClient::logoutAsync() {
     C2S_Logout request;
-    request.session_token = sessionToken;
-    
-    auto response = sendAndReceive<S2C_LogoutAck>(request.to_bytes());
-    
-    if (response.code == ResultCode::SUCCESS) {
-        sessionToken.clear();
-    }
-    
-    return response;
+    request.session_token = requestToken();
+
+    return this->request<S2C_LogoutAck>(request.to_bytes(), PacketType::S2C_LogoutAck,
+                                        [this](const S2C_LogoutAck& response) {
+                                            if (response.code == ResultCode::SUCCESS) {
+                                                std::lock_guard<std::mutex> lock(sessionMutex);
+                                                sessionToken.clear();
+                                                sessionBound = false;
+                                            }
+                                        });
 }
 
-S2C_CreateRoomResult GameClient::createRoom(const std::string& roomName) {
+std::future<S2C_CreateRoomResult> GameClient::createRoomAsync(const std::string& roomName) {
     C2S_CreateRoom request;
-    request.session_token = sessionToken;
+    request.session_token = requestToken();
     request.room_name = roomName;
-    
-    return sendAndReceive<S2C_CreateRoomResult>(request.to_bytes());
+
+    return this->request<S2C_CreateRoomResult>(request.to_bytes(), PacketType::S2C_CreateRoomResult);
 }
 
-S2C_LeaveRoomAck GameClient::leaveRoom(uint32_t roomId) {
+std::future<S2C_LeaveRoomAck> GameClient::leaveRoomAsync(uint32_t roomId) {
     C2S_LeaveRoom request;
-    request.session_token = sessionToken;
+    request.session_token = requestToken();
     request.room_id = roomId;
-    
-    return sendAndReceive<S2C_LeaveRoomAck>(request.to_bytes());
+
+    return this->request<S2C_LeaveRoomAck>(request.to_bytes(), PacketType::S2C_LeaveRoomAck);
+}
+
+std::future<S2C_CreateRoomResult> GameClient::respondInviteAsync(const std::string& fromUsername, bool accept) {
+    C2S_RespondInvite request;
+    request.session_token = requestToken();
+    request.from_username = fromUsername;
+    request.accept = accept;
+
+    if (accept) {
+        return this->request<S2C_CreateRoomResult>(request.to_bytes(), PacketType::S2C_CreateRoomResult);
+    }
+
+    std::promise<S2C_CreateRoomResult> declined;
+    S2C_CreateRoomResult result{};
+    result.code = post(request.to_bytes()) ? ResultCode::FAIL : ResultCode::SERVER_ERROR;
+    result.message = "Declined";
+    declined.set_value(result);
+    return declined.get_future();
+}
+
+S2C_RegisterResult GameClient::registerUser(const std::string& username, const std::string& password) {
+    return await(registerUserAsync(username, password));
+}
+
+S2C_LoginResult GameClient::login(const std::string& username, const std::string& password) {
+    return await(loginAsync(username, password));
+}
+
+S2C_LogoutAck GameClient::logout() {
+    return await(logoutAsync());
+}
+
+S2C_CreateRoomResult GameClient::createRoom(const std::string& roomName) {
+    return await(createRoomAsync(roomName));
+}
+
+S2C_LeaveRoomAck GameClient::leaveRoom(uint32_t roomId) {
+    return await(leaveRoomAsync(roomId));
+}
+
+S2C_CreateRoomResult GameClient::respondInvite(const std::string& fromUsername, bool accept) {
+    return await(respondInviteAsync(fromUsername, accept));
 }
 
 } // namespace hangman
@@ -1,4 +1,5 @@
 #include "protocol/packets.h"
+#include <algorithm>
 #include <stdexcept>
 
 namespace hangman
@@ -21,9 +22,30 @@ namespace hangman
         header.version = bb.read_u8();
         header.type = static_cast<PacketType>(bb.read_u16());
         header.payload_len = bb.read_u32();
+        if (header.version == PROTOCOL_VERSION_V2)
+        {
+            if (len < HEADER_SIZE_V2)
+            {
+                throw std::runtime_error("Insufficient data for packet header");
+            }
+            header.request_id = bb.read_u32();
+        }
         return header;
     }
 
+    std::vector<uint8_t> PacketHeader::to_v2(const std::vector<uint8_t> &packet, uint32_t request_id)
+    {
+        if (packet.size() < HEADER_SIZE)
+        {
+            throw std::runtime_error("Insufficient data for packet header");
+        }
+        std::vector<uint8_t> out(HEADER_SIZE_V2 + packet.size() - HEADER_SIZE);
+        write_header_v2(out.data(), (uint16_t)((packet[1] << 8) | packet[2]), (uint32_t)(packet.size() - HEADER_SIZE),
+                        request_id);
+        std::copy(packet.begin() + HEADER_SIZE, packet.end(), out.begin() + HEADER_SIZE_V2);
+        return out;
+    }
+
     // =====================================================
     //                      C2S_Login
     // =====================================================
@@ -172,6 +194,58 @@ namespace hangman
         return packet;
     }
 
+    // =====================================================
+    //                  C2S_ResumeSession
+    // =====================================================
+    std::vector<uint8_t> C2S_ResumeSession::to_bytes() const
+    {
+        ByteBuffer bb;
+        bb.write_string(session_token);
+
+        std::vector<uint8_t> header_bytes =
+            PacketHeader::encode_header(PROTOCOL_VERSION, PacketType::C2S_ResumeSession, bb.size());
+
+        header_bytes.insert(header_bytes.end(), bb.buf.begin(), bb.buf.end());
+        return header_bytes;
+    }
+
+    C2S_ResumeSession C2S_ResumeSession::from_payload(ByteBuffer &bb)
+    {
+        C2S_ResumeSession packet;
+        packet.session_token = bb.read_string();
+        return packet;
+    }
+
+    // =====================================================
+    //                   S2C_ResumeResult
+    // =====================================================
+    std::vector<uint8_t> S2C_ResumeResult::to_bytes() const
+    {
+        ByteBuffer bb;
+        bb.write_u8(static_cast<uint8_t>(code));
+        bb.write_string(message);
+        bb.write_string(username);
+        bb.write_u16(num_of_wins);
+        bb.write_u16(total_points);
+
+        std::vector<uint8_t> header_bytes =
+            PacketHeader::encode_header(PROTOCOL_VERSION, PacketType::S2C_ResumeResult, bb.size());
+
+        header_bytes.insert(header_bytes.end(), bb.buf.begin(), bb.buf.end());
+        return header_bytes;
+    }
+
+    S2C_ResumeResult S2C_ResumeResult::from_payload(ByteBuffer &bb)
+    {
+        S2C_ResumeResult packet;
+        packet.code = static_cast<ResultCode>(bb.read_u8());
+        packet.message = bb.read_string();
+        packet.username = bb.read_string();
+        packet.num_of_wins = bb.read_u16();
+        packet.total_points = bb.read_u16();
+        return packet;
+    }
+
     // =====================================================
     //                    C2S_CreateRoom
     // =====================================================
@@ -599,53 +673,407 @@ namespace hangman
     }
 
     // =====================================================
-    //         ALL REMAINING PACKETS (Not Implemented)
+    //                    C2S_GuessChar
+    // =====================================================
+    std::vector<uint8_t> C2S_GuessChar::to_bytes() const
+    {
+        ByteBuffer bb;
+        bb.write_string(session_token);
+        bb.write_u32(room_id);
+        bb.write_u32(match_id);
+        bb.write_u8(static_cast<uint8_t>(ch));
+
+        std::vector<uint8_t> header_bytes =
+            PacketHeader::encode_header(PROTOCOL_VERSION, PacketType::C2S_GuessChar, bb.size());
+
+        header_bytes.insert(header_bytes.end(), bb.buf.begin(), bb.buf.end());
+        return header_bytes;
+    }
+
+    C2S_GuessChar C2S_GuessChar::from_payload(ByteBuffer &bb)
+    {
+        C2S_GuessChar packet;
+        packet.session_token = bb.read_string();
+        packet.room_id = bb.read_u32();
+        packet.match_id = bb.read_u32();
+        packet.ch = static_cast<char>(bb.read_u8());
+        return packet;
+    }
+
+    // =====================================================
+    //                 S2C_GuessCharResult
+    // =====================================================
+    std::vector<uint8_t> S2C_GuessCharResult::to_bytes() const
+    {
+        ByteBuffer bb;
+        bb.write_u8(correct ? 1 : 0);
+        bb.write_string(exposed_pattern);
+        bb.write_u8(remaining_attempts);
+
+        std::vector<uint8_t> header_bytes =
+            PacketHeader::encode_header(PROTOCOL_VERSION, PacketType::S2C_GuessCharResult, bb.size());
+
+        header_bytes.insert(header_bytes.end(), bb.buf.begin(), bb.buf.end());
+        return header_bytes;
+    }
+
+    S2C_GuessCharResult S2C_GuessCharResult::from_payload(ByteBuffer &bb)
+    {
+        S2C_GuessCharResult packet;
+        packet.correct = (bb.read_u8() != 0);
+        packet.exposed_pattern = bb.read_string();
+        packet.remaining_attempts = bb.read_u8();
+        return packet;
+    }
+
+    // =====================================================
+    //                    C2S_GuessWord
+    // =====================================================
+    std::vector<uint8_t> C2S_GuessWord::to_bytes() const
+    {
+        ByteBuffer bb;
+        bb.write_string(session_token);
+        bb.write_u32(room_id);
+        bb.write_u32(match_id);
+        bb.write_string(word);
+
+        std::vector<uint8_t> header_bytes =
+            PacketHeader::encode_header(PROTOCOL_VERSION, PacketType::C2S_GuessWord, bb.size());
+
+        header_bytes.insert(header_bytes.end(), bb.buf.begin(), bb.buf.end());
+        return header_bytes;
+    }
+
+    C2S_GuessWord C2S_GuessWord::from_payload(ByteBuffer &bb)
+    {
+        C2S_GuessWord packet;
+        packet.session_token = bb.read_string();
+        packet.room_id = bb.read_u32();
+        packet.match_id = bb.read_u32();
+        packet.word = bb.read_string();
+        return packet;
+    }
+
+    // =====================================================
+    //                 S2C_GuessWordResult
+    // =====================================================
+    std::vector<uint8_t> S2C_GuessWordResult::to_bytes() const
+    {
+        ByteBuffer bb;
+        bb.write_u8(correct ? 1 : 0);
+        bb.write_string(message);
+        bb.write_u8(remaining_attempts);
+
+        std::vector<uint8_t> header_bytes =
+            PacketHeader::encode_header(PROTOCOL_VERSION, PacketType::S2C_GuessWordResult, bb.size());
+
+        header_bytes.insert(header_bytes.end(), bb.buf.begin(), bb.buf.end());
+        return header_bytes;
+    }
+
+    S2C_GuessWordResult S2C_GuessWordResult::from_payload(ByteBuffer &bb)
+    {
+        S2C_GuessWordResult packet;
+        packet.correct = (bb.read_u8() != 0);
+        packet.message = bb.read_string();
+        packet.remaining_attempts = bb.read_u8();
+        return packet;
+    }
+
+    // =====================================================
+    //                   C2S_RequestDraw
+    // =====================================================
+    std::vector<uint8_t> C2S_RequestDraw::to_bytes() const
+    {
+        ByteBuffer bb;
+        bb.write_string(session_token);
+        bb.write_u32(room_id);
+        bb.write_u32(match_id);
+
+        std::vector<uint8_t> header_bytes =
+            PacketHeader::encode_header(PROTOCOL_VERSION, PacketType::C2S_RequestDraw, bb.size());
+
+        header_bytes.insert(header_bytes.end(), bb.buf.begin(), bb.buf.end());
+        return header_bytes;
+    }
+
+    C2S_RequestDraw C2S_RequestDraw::from_payload(ByteBuffer &bb)
+    {
+        C2S_RequestDraw packet;
+        packet.session_token = bb.read_string();
+        packet.room_id = bb.read_u32();
+        packet.match_id = bb.read_u32();
+        return packet;
+    }
+
+    // =====================================================
+    //                   S2C_DrawRequest
+    // =====================================================
+    std::vector<uint8_t> S2C_DrawRequest::to_bytes() const
+    {
+        ByteBuffer bb;
+        bb.write_string(from_username);
+        bb.write_u32(match_id);
+
+        std::vector<uint8_t> header_bytes =
+            PacketHeader::encode_header(PROTOCOL_VERSION, PacketType::S2C_DrawRequest, bb.size());
+
+        header_bytes.insert(header_bytes.end(), bb.buf.begin(), bb.buf.end());
+        return header_bytes;
+    }
+
+    S2C_DrawRequest S2C_DrawRequest::from_payload(ByteBuffer &bb)
+    {
+        S2C_DrawRequest packet;
+        packet.from_username = bb.read_string();
+        packet.match_id = bb.read_u32();
+        return packet;
+    }
+
+    // =====================================================
+    //                     C2S_EndGame
+    // =====================================================
+    std::vector<uint8_t> C2S_EndGame::to_bytes() const
+    {
+        ByteBuffer bb;
+        bb.write_string(session_token);
+        bb.write_u32(room_id);
+        bb.write_u32(match_id);
+        bb.write_u8(result_code);
+        bb.write_string(message);
+
+        std::vector<uint8_t> header_bytes =
+            PacketHeader::encode_header(PROTOCOL_VERSION, PacketType::C2S_EndGame, bb.size());
+
+        header_bytes.insert(header_bytes.end(), bb.buf.begin(), bb.buf.end());
+        return header_bytes;
+    }
+
+    C2S_EndGame C2S_EndGame::from_payload(ByteBuffer &bb)
+    {
+        C2S_EndGame packet;
+        packet.session_token = bb.read_string();
+        packet.room_id = bb.read_u32();
+        packet.match_id = bb.read_u32();
+        packet.result_code = bb.read_u8();
+        packet.message = bb.read_string();
+        return packet;
+    }
+
+    // =====================================================
+    //                     S2C_GameEnd
+    // =====================================================
+    std::vector<uint8_t> S2C_GameEnd::to_bytes() const
+    {
+        ByteBuffer bb;
+        bb.write_u32(match_id);
+        bb.write_u8(result_code);
+        bb.write_string(summary);
+
+        std::vector<uint8_t> header_bytes =
+            PacketHeader::encode_header(PROTOCOL_VERSION, PacketType::S2C_GameEnd, bb.size());
+
+        header_bytes.insert(header_bytes.end(), bb.buf.begin(), bb.buf.end());
+        return header_bytes;
+    }
+
+    S2C_GameEnd S2C_GameEnd::from_payload(ByteBuffer &bb)
+    {
+        S2C_GameEnd packet;
+        packet.match_id = bb.read_u32();
+        packet.result_code = bb.read_u8();
+        packet.summary = bb.read_string();
+        return packet;
+    }
+
+    // =====================================================
+    //                 C2S_RequestHistory
+    // =====================================================
+    std::vector<uint8_t> C2S_RequestHistory::to_bytes() const
+    {
+        ByteBuffer bb;
+        bb.write_string(session_token);
+
+        std::vector<uint8_t> header_bytes =
+            PacketHeader::encode_header(PROTOCOL_VERSION, PacketType::C2S_RequestHistory, bb.size());
+
+        header_bytes.insert(header_bytes.end(), bb.buf.begin(), bb.buf.end());
+        return header_bytes;
+    }
+
+    C2S_RequestHistory C2S_RequestHistory::from_payload(ByteBuffer &bb)
+    {
+        C2S_RequestHistory packet;
+        packet.session_token = bb.read_string();
+        return packet;
+    }
+
+    // =====================================================
+    //                   S2C_HistoryList
+    // =====================================================
+    std::vector<uint8_t> S2C_HistoryList::to_bytes() const
+    {
+        ByteBuffer bb;
+        bb.write_u16(static_cast<uint16_t>(entries.size()));
+        for (const auto& item : entries) {
+            item.write(bb);
+        }
+
+        std::vector<uint8_t> header_bytes =
+            PacketHeader::encode_header(PROTOCOL_VERSION, PacketType::S2C_HistoryList, bb.size());
+
+        header_bytes.insert(header_bytes.end(), bb.buf.begin(), bb.buf.end());
+        return header_bytes;
+    }
+
+    S2C_HistoryList S2C_HistoryList::from_payload(ByteBuffer &bb)
+    {
+        S2C_HistoryList packet;
+        uint16_t count = bb.read_u16();
+        packet.entries.reserve(count);
+        for (uint16_t i = 0; i < count; ++i) {
+            packet.entries.push_back(Entry::read(bb));
+        }
+        return packet;
+    }
+
+    void S2C_HistoryList::Entry::write(ByteBuffer &bb) const
+    {
+        bb.write_u32(match_id);
+        bb.write_string(opponent);
+        bb.write_u8(result_code);
+        bb.write_u32(timestamp);
+        bb.write_string(summary);
+    }
+
+    S2C_HistoryList::Entry S2C_HistoryList::Entry::read(ByteBuffer &bb)
+    {
+        Entry item;
+        item.match_id = bb.read_u32();
+        item.opponent = bb.read_string();
+        item.result_code = bb.read_u8();
+        item.timestamp = bb.read_u32();
+        item.summary = bb.read_string();
+        return item;
+    }
+
+    // =====================================================
+    //               C2S_RequestLeaderboard
     // =====================================================
+    std::vector<uint8_t> C2S_RequestLeaderboard::to_bytes() const
+    {
+        ByteBuffer bb;
+        bb.write_string(session_token);
 
-    std::vector<uint8_t> C2S_GuessChar::to_bytes() const { throw std::runtime_error("Not implemented"); }
-    C2S_GuessChar C2S_GuessChar::from_payload(ByteBuffer &) { throw std::runtime_error("Not implemented"); }
+        std::vector<uint8_t> header_bytes =
+            PacketHeader::encode_header(PROTOCOL_VERSION, PacketType::C2S_RequestLeaderboard, bb.size());
 
-    std::vector<uint8_t> S2C_GuessCharResult::to_bytes() const { throw std::runtime_error("Not implemented"); }
-    S2C_GuessCharResult S2C_GuessCharResult::from_payload(ByteBuffer &) { throw std::runtime_error("Not implemented"); }
+        header_bytes.insert(header_bytes.end(), bb.buf.begin(), bb.buf.end());
+        return header_bytes;
+    }
 
-    std::vector<uint8_t> C2S_GuessWord::to_bytes() const { throw std::runtime_error("Not implemented"); }
-    C2S_GuessWord C2S_GuessWord::from_payload(ByteBuffer &) { throw std::runtime_error("Not implemented"); }
+    C2S_RequestLeaderboard C2S_RequestLeaderboard::from_payload(ByteBuffer &bb)
+    {
+        C2S_RequestLeaderboard packet;
+        packet.session_token = bb.read_string();
+        return packet;
+    }
+
+    // =====================================================
+    //                   S2C_Leaderboard
+    // =====================================================
+    std::vector<uint8_t> S2C_Leaderboard::to_bytes() const
+    {
+        ByteBuffer bb;
+        bb.write_u16(static_cast<uint16_t>(rows.size()));
+        for (const auto& item : rows) {
+            item.write(bb);
+        }
+
+        std::vector<uint8_t> header_bytes =
+            PacketHeader::encode_header(PROTOCOL_VERSION, PacketType::S2C_Leaderboard, bb.size());
 
-    std::vector<uint8_t> S2C_GuessWordResult::to_bytes() const { throw std::runtime_error("Not implemented"); }
-    S2C_GuessWordResult S2C_GuessWordResult::from_payload(ByteBuffer &) { throw std::runtime_error("Not implemented"); }
+        header_bytes.insert(header_bytes.end(), bb.buf.begin(), bb.buf.end());
+        return header_bytes;
+    }
+
+    S2C_Leaderboard S2C_Leaderboard::from_payload(ByteBuffer &bb)
+    {
+        S2C_Leaderboard packet;
+        uint16_t count = bb.read_u16();
+        packet.rows.reserve(count);
+        for (uint16_t i = 0; i < count; ++i) {
+            packet.rows.push_back(Row::read(bb));
+        }
+        return packet;
+    }
 
-    std::vector<uint8_t> C2S_RequestDraw::to_bytes() const { throw std::runtime_error("Not implemented"); }
-    C2S_RequestDraw C2S_RequestDraw::from_payload(ByteBuffer &) { throw std::runtime_error("Not implemented"); }
+    void S2C_Leaderboard::Row::write(ByteBuffer &bb) const
+    {
+        bb.write_string(username);
+        bb.write_u32(wins);
+        bb.write_u32(losses);
+        bb.write_u32(draws);
+    }
 
-    std::vector<uint8_t> S2C_DrawRequest::to_bytes() const { throw std::runtime_error("Not implemented"); }
-    S2C_DrawRequest S2C_DrawRequest::from_payload(ByteBuffer &) { throw std::runtime_error("Not implemented"); }
+    S2C_Leaderboard::Row S2C_Leaderboard::Row::read(ByteBuffer &bb)
+    {
+        Row item;
+        item.username = bb.read_string();
+        item.wins = bb.read_u32();
+        item.losses = bb.read_u32();
+        item.draws = bb.read_u32();
+        return item;
+    }
 
-    std::vector<uint8_t> C2S_EndGame::to_bytes() const { throw std::runtime_error("Not implemented"); }
-    C2S_EndGame C2S_EndGame::from_payload(ByteBuffer &) { throw std::runtime_error("Not implemented"); }
+    // =====================================================
+    //                       S2C_Ack
+    // =====================================================
+    std::vector<uint8_t> S2C_Ack::to_bytes() const
+    {
+        ByteBuffer bb;
+        bb.write_u16(ack_for_type);
+        bb.write_u8(static_cast<uint8_t>(code));
+        bb.write_string(message);
 
-    std::vector<uint8_t> S2C_GameEnd::to_bytes() const { throw std::runtime_error("Not implemented"); }
-    S2C_GameEnd S2C_GameEnd::from_payload(ByteBuffer &) { throw std::runtime_error("Not implemented"); }
+        std::vector<uint8_t> header_bytes =
+            PacketHeader::encode_header(PROTOCOL_VERSION, PacketType::S2C_Ack, bb.size());
 
-    std::vector<uint8_t> C2S_RequestHistory::to_bytes() const { throw std::runtime_error("Not implemented"); }
-    C2S_RequestHistory C2S_RequestHistory::from_payload(ByteBuffer &) { throw std::runtime_error("Not implemented"); }
+        header_bytes.insert(header_bytes.end(), bb.buf.begin(), bb.buf.end());
+        return header_bytes;
+    }
 
-    std::vector<uint8_t> S2C_HistoryList::to_bytes() const { throw std::runtime_error("Not implemented"); }
-    S2C_HistoryList S2C_HistoryList::from_payload(ByteBuffer &) { throw std::runtime_error("Not implemented"); }
-    void S2C_HistoryList::Entry::write(ByteBuffer &) const { throw std::runtime_error("Not implemented"); }
-    S2C_HistoryList::Entry S2C_HistoryList::Entry::read(ByteBuffer &) { throw std::runtime_error("Not implemented"); }
+    S2C_Ack S2C_Ack::from_payload(ByteBuffer &bb)
+    {
+        S2C_Ack packet;
+        packet.ack_for_type = bb.read_u16();
+        packet.code = static_cast<ResultCode>(bb.read_u8());
+        packet.message = bb.read_string();
+        return packet;
+    }
 
-    std::vector<uint8_t> C2S_RequestLeaderboard::to_bytes() const { throw std::runtime_error("Not implemented"); }
-    C2S_RequestLeaderboard C2S_RequestLeaderboard::from_payload(ByteBuffer &) { throw std::runtime_error("Not implemented"); }
+    // =====================================================
+    //                      S2C_Error
+    // =====================================================
+    std::vector<uint8_t> S2C_Error::to_bytes() const
+    {
+        ByteBuffer bb;
+        bb.write_u16(for_type);
+        bb.write_string(message);
 
-    std::vector<uint8_t> S2C_Leaderboard::to_bytes() const { throw std::runtime_error("Not implemented"); }
-    S2C_Leaderboard S2C_Leaderboard::from_payload(ByteBuffer &) { throw std::runtime_error("Not implemented"); }
-    void S2C_Leaderboard::Row::write(ByteBuffer &) const { throw std::runtime_error("Not implemented"); }
-    S2C_Leaderboard::Row S2C_Leaderboard::Row::read(ByteBuffer &) { throw std::runtime_error("Not implemented"); }
+        std::vector<uint8_t> header_bytes =
+            PacketHeader::encode_header(PROTOCOL_VERSION, PacketType::S2C_Error, bb.size());
 
-    std::vector<uint8_t> S2C_Ack::to_bytes() const { throw std::runtime_error("Not implemented"); }
-    S2C_Ack S2C_Ack::from_payload(ByteBuffer &) { throw std::runtime_error("Not implemented"); }
+        header_bytes.insert(header_bytes.end(), bb.buf.begin(), bb.buf.end());
+        return header_bytes;
+    }
 
-    std::vector<uint8_t> S2C_Error::to_bytes() const { throw std::runtime_error("Not implemented"); }
-    S2C_Error S2C_Error::from_payload(ByteBuffer &) { throw std::runtime_error("Not implemented"); }
+    S2C_Error S2C_Error::from_payload(ByteBuffer &bb)
+    {
+        S2C_Error packet;
+        packet.for_type = bb.read_u16();
+        packet.message = bb.read_string();
+        return packet;
+    }
 
 } // namespace hangman
@@ -2,7 +2,10 @@
 #include "ui/LoginScreen.h"
 #include "ui/SignUpScreen.h"
 #include "ui/MainMenuScreen.h"
+#include "ui/InviteNotification.h"
+#include "ui/ClientEventLoop.h"
 #include "network/GameClient.h"
+#include <chrono>
 #include <string>
 
 using namespace hangman;
@@ -42,6 +45,10 @@ void cleanupNcurses() {
     endwin();
 }
 
+// Set when a message was painted over the whole terminal: screens only
+// redraw what changed, so the next one has to be shown in full
+static bool screenCovered = false;
+
 void showMessage(const std::string& title, const std::string& message, int color = 2) {
     clear();
     attron(COLOR_PAIR(color) | A_BOLD);
@@ -53,6 +60,7 @@ void showMessage(const std::string& title, const std::string& message, int color
     attroff(COLOR_PAIR(3));
     
     refresh();
+    screenCovered = true;
 }
 
 bool realLogin(const std::string& username, const std::string& password, UserData& userData) {
@@ -90,6 +98,46 @@ bool realSignUp(const std::string& username, const std::string& password) {
     return response.code == ResultCode::SUCCESS;
 }
 
+// Invite popup over the main menu, closed (declined) when its time runs out
+struct PendingInvite {
+    InviteNotification popup;
+    std::chrono::steady_clock::time_point expiresAt;
+};
+
+static const int INVITE_SECONDS = 15;
+
+// Server pushes, as soon as they arrive
+void handlePush(const GameClient::Packet& packet, PendingInvite& invite) {
+    if (packet.type != static_cast<uint16_t>(PacketType::S2C_InviteReceived)) {
+        return; // Room and game updates: their screens are not wired yet
+    }
+    try {
+        ByteBuffer payloadBuf;
+        payloadBuf.buf = packet.payload;
+        auto received = S2C_InviteReceived::from_payload(payloadBuf);
+        invite.popup.show(received.from_username);
+        invite.expiresAt = std::chrono::steady_clock::now() + std::chrono::seconds(INVITE_SECONDS);
+    } catch (const std::exception&) {
+        // Malformed push: ignore
+    }
+}
+
+// Refresh the countdown; returns ms until it next changes (-1 = no invite)
+int updateInviteCountdown(PendingInvite& invite) {
+    if (!invite.popup.active()) {
+        return -1;
+    }
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+        invite.expiresAt - std::chrono::steady_clock::now()).count();
+    if (left <= 0) {
+        GameClient::getInstance().respondInviteAsync(invite.popup.getFromUsername(), false);
+        invite.popup.hide();
+        return -1;
+    }
+    invite.popup.setCountdown((int)((left + 999) / 1000));
+    return (int)((left - 1) % 1000) + 1;
+}
+
 void showComingSoon(const std::string& feature) {
     clear();
     
@@ -107,6 +155,7 @@ void showComingSoon(const std::string& feature) {
     
     refresh();
     getch();
+    screenCovered = true;
 }
 
 int main() {
@@ -120,11 +169,30 @@ int main() {
     UserData currentUser;
     bool running = true;
     
+    // Keys and server pushes come through one loop: no screen blocks in wgetch
+    ClientEventLoop events;
+    PendingInvite invite;
+    bool inviteShown = false;
+    AppScreen shownScreen = AppScreen::EXIT;
+    
     while (running) {
+        // Another screen or a message was on the terminal: show this one in full
+        if (currentScreen != shownScreen || screenCovered) {
+            loginScreen.invalidate();
+            signupScreen.invalidate();
+            mainMenuScreen.invalidate();
+            shownScreen = currentScreen;
+            screenCovered = false;
+        }
+        
         switch(currentScreen) {
             case AppScreen::LOGIN: {
                 loginScreen.draw();
-                int result = loginScreen.handleInput();
+                auto event = events.wait(loginScreen.getWindow());
+                if (event.type != ClientEventLoop::EventType::KEY) {
+                    break;
+                }
+                int result = loginScreen.handleKey(event.key);
                 
                 switch(result) {
                     case -1:  // Exit
@@ -168,7 +236,11 @@ int main() {
             
             case AppScreen::SIGNUP: {
                 signupScreen.draw();
-                int result = signupScreen.handleInput();
+                auto event = events.wait(signupScreen.getWindow());
+                if (event.type != ClientEventLoop::EventType::KEY) {
+                    break;
+                }
+                int result = signupScreen.handleKey(event.key);
                 
                 switch(result) {
                     case -1:  // Back to Login
@@ -203,8 +275,48 @@ int main() {
             }
             
             case AppScreen::MAIN_MENU: {
+                int nextTickMs = updateInviteCountdown(invite);
+                if (inviteShown && !invite.popup.active()) {
+                    mainMenuScreen.invalidate(); // Uncover what the popup hid
+                }
+                inviteShown = invite.popup.active();
+                // Requests reconnect by themselves: show the link as it is now
+                mainMenuScreen.setConnected(GameClient::getInstance().isConnected());
                 mainMenuScreen.draw();
-                int result = mainMenuScreen.handleInput();
+                invite.popup.draw();
+                
+                // Keys go to the invite popup while it is open
+                WINDOW* inputWin = invite.popup.active() ? invite.popup.getWindow()
+                                                          : mainMenuScreen.getWindow();
+                auto event = events.wait(inputWin, nextTickMs);
+                if (event.type == ClientEventLoop::EventType::PACKET) {
+                    handlePush(event.packet, invite);
+                    break;
+                }
+                if (event.type != ClientEventLoop::EventType::KEY) {
+                    break; // Countdown tick, or the link dropped (redrawn above)
+                }
+                
+                if (invite.popup.active()) {
+                    int answer = invite.popup.handleKey(event.key);
+                    if (answer != 0) {
+                        std::string from = invite.popup.getFromUsername();
+                        invite.popup.hide();
+                        auto response = GameClient::getInstance().respondInvite(from, answer == 1);
+                        if (answer == 1) {
+                            if (response.code == ResultCode::SUCCESS) {
+                                showMessage("Invite accepted!", "Joined " + from + "'s room #" +
+                                            std::to_string(response.room_id), 2);
+                            } else {
+                                showMessage("Could not join", response.message, 6);
+                            }
+                            napms(1500);
+                        }
+                    }
+                    break;
+                }
+                
+                int result = mainMenuScreen.handleKey(event.key);
                 
                 switch(result) {
                     case 1:  // Create Room
@@ -226,6 +338,7 @@ int main() {
                             mvprintw(LINES/2, (COLS - 20)/2, "Logging out...");
                             attroff(COLOR_PAIR(4));
                             refresh();
+                            screenCovered = true;
                             
                             // Logout from server
                             auto& client = GameClient::getInstance();
@@ -235,6 +348,7 @@ int main() {
                             
                             napms(1000);
                             
+                            invite.popup.hide();
                             loginScreen.reset();
                             currentScreen = AppScreen::LOGIN;
                         }
@@ -0,0 +1,89 @@
+#include "ui/ClientEventLoop.h"
+#include <cerrno>
+#include <chrono>
+#include <poll.h>
+#include <unistd.h>
+
+using namespace hangman;
+
+void ClientEventLoop::drain(WINDOW* win) {
+    // ncurses buffers what it reads from stdin: take every key it has, so
+    // poll() below only waits when the buffer is really empty
+    bool blocking = !is_nodelay(win);
+    nodelay(win, TRUE);
+    int ch;
+    while ((ch = wgetch(win)) != ERR) {
+        Event event;
+        event.type = EventType::KEY;
+        event.key = ch;
+        events.push_back(std::move(event));
+    }
+    if (blocking) {
+        nodelay(win, FALSE);
+    }
+
+    GameClient& client = GameClient::getInstance();
+    if (client.isConnected()) {
+        dropReported = false; // Connected (again): report the next drop
+    }
+
+    GameClient::Packet packet;
+    while (client.pollNotification(packet)) {
+        Event event;
+        event.type = EventType::PACKET;
+        event.packet = std::move(packet);
+        events.push_back(std::move(event));
+    }
+}
+
+ClientEventLoop::Event ClientEventLoop::wait(WINDOW* win, int timeoutMs) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    int notifyFd = GameClient::getInstance().getNotificationFd();
+
+    while (true) {
+        drain(win);
+        if (!events.empty()) {
+            Event event = std::move(events.front());
+            events.pop_front();
+            return event;
+        }
+
+        int waitMs = -1;
+        if (timeoutMs >= 0) {
+            auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            if (left.count() <= 0) {
+                return Event{};
+            }
+            waitMs = (int)left.count();
+        }
+
+        struct pollfd fds[2] = {
+            {stdinOpen ? STDIN_FILENO : -1, POLLIN, 0},
+            {notifyFd, POLLIN, 0}
+        };
+        int n = poll(fds, 2, waitMs);
+        if (n < 0 && errno != EINTR) {
+            return Event{};
+        }
+        // EINTR is usually SIGWINCH: ncurses then has a KEY_RESIZE queued
+
+        if (n > 0 && (fds[0].revents & (POLLHUP | POLLERR | POLLNVAL))) {
+            stdinOpen = false; // Terminal gone: keep serving pushes and timeouts
+        }
+
+        if (n > 0 && (fds[1].revents & POLLIN)) {
+            // Reset the eventfd; the queue itself is drained above
+            uint64_t value;
+            (void)read(notifyFd, &value, sizeof(value));
+
+            // The receive thread also signals when it stops: tell the screen
+            if (!GameClient::getInstance().isConnected() && !dropReported) {
+                dropReported = true;
+                Event event;
+                event.type = EventType::DISCONNECTED;
+                events.push_back(std::move(event));
+            }
+        }
+    }
+}
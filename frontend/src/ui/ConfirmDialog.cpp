@@ -123,7 +123,11 @@ void ConfirmDialog::draw() {
 int ConfirmDialog::handleInput() {
     if (!isActive || !dialogWin) return 0;
     
-    int ch = wgetch(dialogWin);
+    return handleKey(wgetch(dialogWin));
+}
+
+int ConfirmDialog::handleKey(int ch) {
+    if (!isActive || !dialogWin) return 0;
     
     switch(ch) {
         case KEY_LEFT:
@@ -25,6 +25,9 @@ void InviteNotification::show(const std::string& from) {
     int startY = (height - BOX_HEIGHT) / 2;
     int startX = (width - BOX_WIDTH) / 2;
     
+    if (overlayWin) {
+        delwin(overlayWin);  // Replaces an invite still on screen
+    }
     overlayWin = newwin(BOX_HEIGHT, BOX_WIDTH, startY, startX);
     keypad(overlayWin, TRUE);
     nodelay(overlayWin, TRUE);  // Non-blocking input
@@ -135,7 +138,11 @@ void InviteNotification::draw() {
 int InviteNotification::handleInput() {
     if (!isActive || !overlayWin) return 0;
     
-    int ch = wgetch(overlayWin);
+    return handleKey(wgetch(overlayWin));
+}
+
+int InviteNotification::handleKey(int ch) {
+    if (!isActive || !overlayWin) return 0;
     
     if (ch == ERR) return 0;  // No input
     
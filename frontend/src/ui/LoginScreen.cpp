@@ -21,6 +21,16 @@ LoginScreen::LoginScreen()
     init_pair(3, COLOR_WHITE, COLOR_BLACK);   // Normal
     init_pair(4, COLOR_RED, COLOR_BLACK);     // Error
     init_pair(5, COLOR_YELLOW, COLOR_BLACK);  // Active field
+    
+    // Border and title are drawn once
+    layer.setWindow(mainWin);
+    layer.addStatic([this] {
+        drawBorder();
+        drawTitle();
+    });
+    fieldsRegion = layer.addRegion(10, 1, 3, width - 2, [this] { drawInputFields(); });
+    menuRegion = layer.addRegion(MENU_START_Y, 1, 7, width - 2, [this] { drawMenu(); });
+    messageRegion = layer.addRegion(height - 3, 1, 1, width - 2, [this] { drawError(); });
 }
 
 LoginScreen::~LoginScreen() {
@@ -144,13 +154,19 @@ void LoginScreen::clearError() {
 }
 
 void LoginScreen::draw() {
-    werase(mainWin);
-    drawBorder();
-    drawTitle();
-    drawInputFields();
-    drawMenu();
-    drawError();
-    wrefresh(mainWin);
+    if (layer.render()) {
+        doupdate();
+    }
+}
+
+void LoginScreen::invalidate() {
+    layer.touch();
+}
+
+void LoginScreen::markDirty() {
+    layer.invalidate(fieldsRegion);
+    layer.invalidate(menuRegion);
+    layer.invalidate(messageRegion);
 }
 
 void LoginScreen::handleMenuNavigation(int ch) {
@@ -259,7 +275,11 @@ bool LoginScreen::validateInput() {
 }
 
 int LoginScreen::handleInput() {
-    int ch = wgetch(mainWin);
+    return handleKey(wgetch(mainWin));
+}
+
+int LoginScreen::handleKey(int ch) {
+    markDirty();
     
     if (activeField != InputField::NONE) {
         // Currently editing a field
@@ -312,10 +332,12 @@ int LoginScreen::handleInput() {
 }
 
 void LoginScreen::setError(const std::string& msg) {
+    markDirty();
     errorMessage = msg;
 }
 
 void LoginScreen::reset() {
+    markDirty();
     username = "";
     password = "";
     errorMessage = "";
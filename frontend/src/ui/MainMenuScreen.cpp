@@ -28,6 +28,19 @@ MainMenuScreen::MainMenuScreen()
     init_pair(4, COLOR_YELLOW, COLOR_BLACK);    // Info/Stats
     init_pair(5, COLOR_MAGENTA, COLOR_BLACK);   // Decoration
     init_pair(6, COLOR_RED, COLOR_BLACK);       // Logout/Quit
+    
+    // Everything but the menu only changes with the user info
+    layer.setWindow(mainWin);
+    layer.addStatic([this] {
+        drawBorder();
+        drawTitle();
+        drawDecoration();
+        drawInstructions();
+    });
+    menuRegion = layer.addRegion(MENU_START_Y, MENU_CENTER_X - 2, 9, MENU_ITEM_WIDTH + 2, [this] { drawMenu(); });
+    infoLayer.setWindow(infoWin);
+    infoLayer.addStatic([this] { drawUserInfo(); });
+    linkRegion = infoLayer.addRegion(INFO_BOX_HEIGHT - 1, 2, 1, LINK_STATE_WIDTH, [this] { drawLinkState(); });
 }
 
 MainMenuScreen::~MainMenuScreen() {
@@ -107,13 +120,21 @@ void MainMenuScreen::drawUserInfo() {
     wattron(infoWin, COLOR_PAIR(6));
     mvwprintw(infoWin, 6, 11, "%d", userLosses);
     wattroff(infoWin, COLOR_PAIR(6));
-    
-    wrefresh(infoWin);
+}
+
+void MainMenuScreen::drawLinkState() {
+    // The region covers part of the border: draw that back first
+    mvwhline(infoWin, INFO_BOX_HEIGHT - 1, 2, ACS_HLINE, LINK_STATE_WIDTH);
+    if (!connected) {
+        wattron(infoWin, COLOR_PAIR(6) | A_BOLD);
+        mvwprintw(infoWin, INFO_BOX_HEIGHT - 1, 2, "[ OFFLINE ]");
+        wattroff(infoWin, COLOR_PAIR(6) | A_BOLD);
+    }
 }
 
 void MainMenuScreen::drawMenu() {
     int startY = MENU_START_Y;
-    int centerX = 40;
+    int centerX = MENU_CENTER_X;
     
     // Menu items with icons
     const char* menuItems[] = {
@@ -200,17 +221,23 @@ void MainMenuScreen::drawDecoration() {
 }
 
 void MainMenuScreen::draw() {
-    werase(mainWin);
-    drawBorder();
-    drawTitle();
-    drawDecoration();
-    drawMenu();
-    drawInstructions();
-    drawUserInfo();
-    wrefresh(mainWin);
+    // The info box lies over the main window: stage it after any change there
+    if (layer.render()) {
+        infoLayer.touch();
+    }
+    if (infoLayer.render()) {
+        doupdate();
+    }
+}
+
+void MainMenuScreen::invalidate() {
+    layer.touch();
+    infoLayer.touch();
 }
 
 void MainMenuScreen::handleNavigation(int ch) {
+    layer.invalidate(menuRegion);
+    
     switch(ch) {
         case KEY_UP:
             if (selectedOption == MenuOption::CREATE_ROOM) {
@@ -233,7 +260,10 @@ void MainMenuScreen::handleNavigation(int ch) {
 }
 
 int MainMenuScreen::handleInput() {
-    int ch = wgetch(mainWin);
+    return handleKey(wgetch(mainWin));
+}
+
+int MainMenuScreen::handleKey(int ch) {
     
     if (ch == KEY_UP || ch == KEY_DOWN) {
         handleNavigation(ch);
@@ -283,4 +313,13 @@ void MainMenuScreen::setUserInfo(const std::string& name, int level, int wins, i
     userLevel = level;
     userWins = wins;
     userLosses = losses;
+    layer.invalidateAll();
+    infoLayer.invalidateAll();
+}
+
+void MainMenuScreen::setConnected(bool isConnected) {
+    if (connected != isConnected) {
+        connected = isConnected;
+        infoLayer.invalidate(linkRegion);
+    }
 }
\ No newline at end of file
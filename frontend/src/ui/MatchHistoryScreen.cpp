@@ -19,6 +19,23 @@ MatchHistoryScreen::MatchHistoryScreen()
     init_pair(4, COLOR_RED, COLOR_BLACK);
     init_pair(5, COLOR_YELLOW, COLOR_BLACK);
     init_pair(6, COLOR_MAGENTA, COLOR_BLACK);
+    
+    // Border, title and header only change with the data
+    layer.setWindow(mainWin);
+    layer.addStatic([this] {
+        drawBorder();
+        drawTitle();
+        if (!matches.empty()) {
+            drawHeader();
+        }
+    });
+    listRegion = layer.addRegion(LIST_START_Y + 1, 1, ITEMS_PER_PAGE, width - 2, [this] { drawMatchList(); });
+    detailRegion = layer.addRegion(LIST_START_Y + LIST_HEIGHT + 2, 1, 7, width - 2, [this] {
+        if (showDetail) {
+            drawDetailView();
+        }
+    });
+    footerRegion = layer.addRegion(height - 3, 1, 1, width - 2, [this] { drawInstructions(); });
 }
 
 MatchHistoryScreen::~MatchHistoryScreen() {
@@ -176,28 +193,22 @@ void MatchHistoryScreen::drawInstructions() {
 }
 
 void MatchHistoryScreen::draw() {
-    werase(mainWin);
-    drawBorder();
-    drawTitle();
-    
-    if (!matches.empty()) {
-        drawHeader();
-        drawMatchList();
-        
-        if (showDetail) {
-            drawDetailView();
-        }
-    } else {
-        drawNoData();
+    if (layer.render()) {
+        doupdate();
     }
-    
-    drawInstructions();
-    wrefresh(mainWin);
+}
+
+void MatchHistoryScreen::invalidate() {
+    layer.touch();
 }
 
 void MatchHistoryScreen::handleNavigation(int ch) {
     if (matches.empty()) return;
     
+    layer.invalidate(listRegion);
+    layer.invalidate(detailRegion);
+    layer.invalidate(footerRegion);
+    
     switch(ch) {
         case KEY_UP:
             if (selectedIndex > 0) {
@@ -225,7 +236,10 @@ void MatchHistoryScreen::handleNavigation(int ch) {
 }
 
 int MatchHistoryScreen::handleInput() {
-    int ch = wgetch(mainWin);
+    return handleKey(wgetch(mainWin));
+}
+
+int MatchHistoryScreen::handleKey(int ch) {
     
     if (ch == 27 || ch == 'b' || ch == 'B') {  // ESC or B
         return -1;  // Back to menu
@@ -270,6 +284,7 @@ void MatchHistoryScreen::setMatches(const std::vector<MatchRecord>& matchList) {
     selectedIndex = 0;
     scrollOffset = 0;
     showDetail = false;
+    layer.invalidateAll();
 }
 
 void MatchHistoryScreen::reset() {
@@ -277,4 +292,5 @@ void MatchHistoryScreen::reset() {
     selectedIndex = 0;
     scrollOffset = 0;
     showDetail = false;
+    layer.invalidateAll();
 }
\ No newline at end of file
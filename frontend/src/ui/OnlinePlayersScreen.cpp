@@ -198,7 +198,10 @@ void OnlinePlayersScreen::handleNavigation(int ch) {
 }
 
 int OnlinePlayersScreen::handleInput() {
-    int ch = wgetch(mainWin);
+    return handleKey(wgetch(mainWin));
+}
+
+int OnlinePlayersScreen::handleKey(int ch) {
     
     if (ch == 27 || ch == 'b' || ch == 'B') {  // ESC or B
         if (inviteStatus == InviteStatus::WAITING) {
@@ -20,6 +20,20 @@ RankingsScreen::RankingsScreen()
     init_pair(4, COLOR_RED, COLOR_BLACK);
     init_pair(5, COLOR_YELLOW, COLOR_BLACK);
     init_pair(6, COLOR_MAGENTA, COLOR_BLACK);
+    
+    // Border, title, podium and header only change with the data
+    layer.setWindow(mainWin);
+    layer.addStatic([this] {
+        drawBorder();
+        drawTitle();
+        if (!rankings.empty()) {
+            drawPodium();
+            drawHeader();
+        }
+    });
+    listRegion = layer.addRegion(LIST_START_Y + 1, 1, ITEMS_PER_PAGE, width - 2,
+                                 [this] { drawRankingsList(); });
+    footerRegion = layer.addRegion(height - 4, 1, 2, width - 2, [this] { drawInstructions(); });
 }
 
 RankingsScreen::~RankingsScreen() {
@@ -203,25 +217,21 @@ void RankingsScreen::drawInstructions() {
 }
 
 void RankingsScreen::draw() {
-    werase(mainWin);
-    drawBorder();
-    drawTitle();
-    
-    if (!rankings.empty()) {
-        drawPodium();
-        drawHeader();
-        drawRankingsList();
-    } else {
-        drawNoData();
+    if (layer.render()) {
+        doupdate();
     }
-    
-    drawInstructions();
-    wrefresh(mainWin);
+}
+
+void RankingsScreen::invalidate() {
+    layer.touch();
 }
 
 void RankingsScreen::handleNavigation(int ch) {
     if (rankings.empty()) return;
     
+    layer.invalidate(listRegion);
+    layer.invalidate(footerRegion);
+    
     switch(ch) {
         case KEY_UP:
             if (selectedIndex > 0) {
@@ -244,7 +254,10 @@ void RankingsScreen::handleNavigation(int ch) {
 }
 
 int RankingsScreen::handleInput() {
-    int ch = wgetch(mainWin);
+    return handleKey(wgetch(mainWin));
+}
+
+int RankingsScreen::handleKey(int ch) {
     
     if (ch == 27 || ch == 'b' || ch == 'B') {  // ESC or B
         return -1;  // Back to menu
@@ -270,6 +283,7 @@ void RankingsScreen::setRankings(const std::vector<PlayerRanking>& rankList) {
     
     selectedIndex = 0;
     scrollOffset = 0;
+    layer.invalidateAll();
     
     // Auto-scroll to current user if exists
     if (!currentUser.empty()) {
@@ -287,10 +301,12 @@ void RankingsScreen::setRankings(const std::vector<PlayerRanking>& rankList) {
 
 void RankingsScreen::setCurrentUser(const std::string& username) {
     currentUser = username;
+    layer.invalidateAll();
 }
 
 void RankingsScreen::reset() {
     rankings.clear();
     selectedIndex = 0;
     scrollOffset = 0;
+    layer.invalidateAll();
 }
\ No newline at end of file
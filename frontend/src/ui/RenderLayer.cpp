@@ -0,0 +1,72 @@
+#include "ui/RenderLayer.h"
+
+void RenderLayer::addStatic(std::function<void()> draw) {
+    regions.push_back({0, 0, 0, 0, std::move(draw), true});
+    eraseAll = true;
+}
+
+int RenderLayer::addRegion(int y, int x, int h, int w, std::function<void()> draw) {
+    regions.push_back({y, x, h, w, std::move(draw), true});
+    eraseAll = true;
+    return (int)regions.size() - 1;
+}
+
+void RenderLayer::invalidate(int region) {
+    if (region >= 0 && region < (int)regions.size()) {
+        regions[region].dirty = true;
+    }
+}
+
+void RenderLayer::invalidateAll() {
+    eraseAll = true;
+}
+
+void RenderLayer::touch() {
+    touched = true;
+}
+
+void RenderLayer::clearRect(const Region& region) {
+    int maxY, maxX;
+    getmaxyx(win, maxY, maxX);
+    int w = region.x + region.w <= maxX ? region.w : maxX - region.x;
+    if (w <= 0) {
+        return;
+    }
+    wattrset(win, A_NORMAL);
+    for (int y = region.y; y < region.y + region.h && y < maxY; y++) {
+        mvwhline(win, y, region.x, ' ', w);
+    }
+}
+
+bool RenderLayer::render() {
+    if (!win) {
+        return false;
+    }
+
+    bool changed = touched;
+    if (eraseAll) {
+        werase(win);
+    }
+    for (Region& region : regions) {
+        if (eraseAll) {
+            region.draw();
+        } else if (region.dirty && region.h > 0) {
+            clearRect(region);
+            region.draw();
+            changed = true;
+        }
+        region.dirty = false;
+    }
+    changed = changed || eraseAll;
+
+    if (touched && !eraseAll) {
+        touchwin(win); // Copy every line, not only the redrawn ones
+    }
+    eraseAll = false;
+    touched = false;
+
+    if (changed) {
+        wnoutrefresh(win);
+    }
+    return changed;
+}
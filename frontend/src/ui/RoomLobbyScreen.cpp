@@ -198,7 +198,10 @@ void RoomLobbyScreen::draw() {
 }
 
 int RoomLobbyScreen::handleInput() {
-    int ch = wgetch(mainWin);
+    return handleKey(wgetch(mainWin));
+}
+
+int RoomLobbyScreen::handleKey(int ch) {
     
     switch(ch) {
         case KEY_LEFT:
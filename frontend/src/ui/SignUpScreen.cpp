@@ -24,6 +24,16 @@ SignUpScreen::SignUpScreen()
     init_pair(4, COLOR_RED, COLOR_BLACK);     // Error
     init_pair(5, COLOR_YELLOW, COLOR_BLACK);  // Active field
     init_pair(6, COLOR_GREEN, COLOR_BLACK);   // Success message
+    
+    // Border and title are drawn once
+    layer.setWindow(mainWin);
+    layer.addStatic([this] {
+        drawBorder();
+        drawTitle();
+    });
+    fieldsRegion = layer.addRegion(10, 1, 7, width - 2, [this] { drawInputFields(); });
+    menuRegion = layer.addRegion(MENU_START_Y, 1, 5, width - 2, [this] { drawMenu(); });
+    messageRegion = layer.addRegion(height - 4, 1, 1, width - 2, [this] { drawMessages(); });
 }
 
 SignUpScreen::~SignUpScreen() {
@@ -166,13 +176,19 @@ void SignUpScreen::clearMessages() {
 }
 
 void SignUpScreen::draw() {
-    werase(mainWin);
-    drawBorder();
-    drawTitle();
-    drawInputFields();
-    drawMenu();
-    drawMessages();
-    wrefresh(mainWin);
+    if (layer.render()) {
+        doupdate();
+    }
+}
+
+void SignUpScreen::invalidate() {
+    layer.touch();
+}
+
+void SignUpScreen::markDirty() {
+    layer.invalidate(fieldsRegion);
+    layer.invalidate(menuRegion);
+    layer.invalidate(messageRegion);
 }
 
 void SignUpScreen::handleMenuNavigation(int ch) {
@@ -318,7 +334,11 @@ bool SignUpScreen::validateInput() {
 }
 
 int SignUpScreen::handleInput() {
-    int ch = wgetch(mainWin);
+    return handleKey(wgetch(mainWin));
+}
+
+int SignUpScreen::handleKey(int ch) {
+    markDirty();
     
     if (activeField != SignUpField::NONE) {
         // Currently editing a field
@@ -359,16 +379,19 @@ int SignUpScreen::handleInput() {
 }
 
 void SignUpScreen::setError(const std::string& msg) {
+    markDirty();
     errorMessage = msg;
     successMessage = "";
 }
 
 void SignUpScreen::setSuccess(const std::string& msg) {
+    markDirty();
     successMessage = msg;
     errorMessage = "";
 }
 
 void SignUpScreen::reset() {
+    markDirty();
     username = "";
     password = "";
     confirmPassword = "";